@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// MIT License
+// 
+// Copyright (c) 2022-2023 underwatergrasshopper
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+// Measures cost of passing assertions against raw condition check.
+// Each iteration checks 8 conditions, so time per single check is 1/8 of reported time.
+
+#include "TrivialTestKit.h"
+
+enum { LIMIT = 1000000 };
+
+TTK_BENCHMARK(BenchmarkRawIf, 0) {
+    uint64_t value      = 0;
+    uint64_t fail_count = 0;
+
+    while (state.KeepRunning()) {
+        TTK_DoNotOptimize(value);
+        if (!(value + 0 < LIMIT)) fail_count += 1;
+        if (!(value + 1 < LIMIT)) fail_count += 1;
+        if (!(value + 2 < LIMIT)) fail_count += 1;
+        if (!(value + 3 < LIMIT)) fail_count += 1;
+        if (!(value + 4 < LIMIT)) fail_count += 1;
+        if (!(value + 5 < LIMIT)) fail_count += 1;
+        if (!(value + 6 < LIMIT)) fail_count += 1;
+        if (!(value + 7 < LIMIT)) fail_count += 1;
+        TTK_DoNotOptimize(fail_count);
+    }
+}
+
+TTK_BENCHMARK(BenchmarkAssert, 0) {
+    uint64_t value = 0;
+
+    while (state.KeepRunning()) {
+        TTK_DoNotOptimize(value);
+        TTK_ASSERT(value + 0 < LIMIT);
+        TTK_ASSERT(value + 1 < LIMIT);
+        TTK_ASSERT(value + 2 < LIMIT);
+        TTK_ASSERT(value + 3 < LIMIT);
+        TTK_ASSERT(value + 4 < LIMIT);
+        TTK_ASSERT(value + 5 < LIMIT);
+        TTK_ASSERT(value + 6 < LIMIT);
+        TTK_ASSERT(value + 7 < LIMIT);
+    }
+}
+
+TTK_BENCHMARK(BenchmarkExpect, 0) {
+    uint64_t value = 0;
+
+    while (state.KeepRunning()) {
+        TTK_DoNotOptimize(value);
+        TTK_EXPECT(value + 0 < LIMIT);
+        TTK_EXPECT(value + 1 < LIMIT);
+        TTK_EXPECT(value + 2 < LIMIT);
+        TTK_EXPECT(value + 3 < LIMIT);
+        TTK_EXPECT(value + 4 < LIMIT);
+        TTK_EXPECT(value + 5 < LIMIT);
+        TTK_EXPECT(value + 6 < LIMIT);
+        TTK_EXPECT(value + 7 < LIMIT);
+    }
+}
+
+int main() {
+    const bool is_success = TTK_Run();
+    TTK_Clear();
+    return is_success ? 0 : 1;
+}
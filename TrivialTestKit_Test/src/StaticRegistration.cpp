@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+// MIT License
+// 
+// Copyright (c) 2022-2023 underwatergrasshopper
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+// Compiled with TTK_STATIC_REGISTRATION (see CMakeLists.txt and TrivialTestKit_Test.vcxproj), unlike other source files.
+#include "Tests.h"
+#include "TrivialTestKit.h"
+
+extern uint64_t g_test_finish_counter;
+
+bool IsStaticRegistrationAvailable() {
+#if defined(TTK_STATIC_REGISTRATION_AVAILABLE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Test functions are executed in order of source file name and line, so TestStaticB_InPlace goes first, 
+// and TestStaticC_InPlace from included header goes last.
+#if defined(TTK_STATIC_REGISTRATION_AVAILABLE)
+TTK_TEST(TestStaticB_InPlace, 0) {
+    TTK_ASSERT(1 == 1);
+
+    g_test_finish_counter += 1;
+}
+
+TTK_TEST(TestStaticA_InPlace, 0) {
+    TTK_ASSERT(2 == 2);
+
+    g_test_finish_counter += 1;
+}
+
+#include "StaticRegistration.h"
+#endif
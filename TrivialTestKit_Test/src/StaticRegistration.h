@@ -0,0 +1,15 @@
+#ifndef STATICREGISTRATION_H_
+#define STATICREGISTRATION_H_
+
+#include "TrivialTestKit.h"
+
+extern uint64_t g_test_finish_counter;
+
+// Included only by StaticRegistration.cpp.
+TTK_TEST(TestStaticC_InPlace, 0) {
+    TTK_ASSERT(3 == 3);
+
+    g_test_finish_counter += 1;
+}
+
+#endif // STATICREGISTRATION_H_
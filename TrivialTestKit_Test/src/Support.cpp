@@ -33,3 +33,11 @@ bool IsStdOutWideOriented() {
     return s_is_wide_oriented;
 }
 
+#if !defined(_WIN32)
+
+std::string GetDefSolutionDir_UTF8() {
+    const std::string file_name = __FILE__;
+    return file_name.substr(0, file_name.rfind("/TrivialTestKit_Test/src/Support.cpp"));
+}
+
+#endif
@@ -25,8 +25,18 @@
 #ifndef SUPPORT_H_
 #define SUPPORT_H_
 
+#if defined(_WIN32)
 #include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <sys/stat.h>
+#endif
+
 #include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 
 #include <string>
 
@@ -37,12 +47,28 @@ bool IsStdOutWideOriented();
 
 //------------------------------------------------------------------------------
 
+// Returns nullptr, if file can not be opened.
+inline FILE* OpenFile(const std::string& file_name, const char* mode) {
+#if defined(_WIN32)
+    FILE* file = nullptr;
+    if (fopen_s(&file, file_name.c_str(), mode) != 0) return nullptr;
+    return file;
+#else
+    return fopen(file_name.c_str(), mode);
+#endif
+}
+
 class Output {
 public:
     Output() : m_out(nullptr) {}
 
     explicit Output(const std::string& file_name) : m_out(nullptr) {
-        if (fopen_s(&m_out, file_name.c_str(), "w") != 0) m_out = nullptr;
+        m_out = OpenFile(file_name, "w");
+
+#if defined(_WIN32)
+        // Wide characters are stored in file as utf-8.
+        if (m_out && IsStdOutWideOriented()) _setmode(_fileno(m_out), _O_U8TEXT);
+#endif
     }
 
     virtual ~Output() {
@@ -58,6 +84,8 @@ private:
 
 //------------------------------------------------------------------------------
 
+#if defined(_WIN32)
+
 inline std::wstring ToUTF16(const std::string& text) {
     std::wstring text_utf16;
 
@@ -119,6 +147,54 @@ inline std::string ToUTF8(const std::wstring& text) {
     return text_utf8;
 }
 
+#else
+
+// Wide characters are utf-32, so each code point is stored in single wchar_t.
+inline std::wstring ToUTF16(const std::string& text) {
+    std::wstring text_utf16;
+
+    for (size_t index = 0; index < text.length();) {
+        const uint8_t lead = uint8_t(text[index]);
+        const size_t count = (lead < 0x80) ? 1 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : 4;
+
+        uint32_t code_point = (count == 1) ? lead : (lead & (0x7F >> count));
+        for (size_t offset = 1; offset < count && index + offset < text.length(); ++offset) {
+            code_point = (code_point << 6) | (uint8_t(text[index + offset]) & 0x3F);
+        }
+
+        text_utf16 += wchar_t(code_point);
+        index += count;
+    }
+    return text_utf16;
+}
+
+inline std::string ToUTF8(const std::wstring& text) {
+    std::string text_utf8;
+
+    for (const wchar_t character : text) {
+        const uint32_t code_point = uint32_t(character);
+
+        if (code_point < 0x80) {
+            text_utf8 += char(code_point);
+        } else if (code_point < 0x800) {
+            text_utf8 += char(0xC0 | (code_point >> 6));
+            text_utf8 += char(0x80 | (code_point & 0x3F));
+        } else if (code_point < 0x10000) {
+            text_utf8 += char(0xE0 | (code_point >> 12));
+            text_utf8 += char(0x80 | ((code_point >> 6) & 0x3F));
+            text_utf8 += char(0x80 | (code_point & 0x3F));
+        } else {
+            text_utf8 += char(0xF0 | (code_point >> 18));
+            text_utf8 += char(0x80 | ((code_point >> 12) & 0x3F));
+            text_utf8 += char(0x80 | ((code_point >> 6) & 0x3F));
+            text_utf8 += char(0x80 | (code_point & 0x3F));
+        }
+    }
+    return text_utf8;
+}
+
+#endif
+
 //------------------------------------------------------------------------------
 
 inline void InnerNotice(const std::string& caller_name, const std::wstring& caller_name_utf16) {
@@ -137,6 +213,8 @@ inline void InnerNotice(const std::string& caller_name, const std::wstring& call
 
 //------------------------------------------------------------------------------
 
+#if defined(_WIN32)
+
 inline bool IsFileExist_ASCII(const std::string& file_name) {
     DWORD attributes = GetFileAttributesA(file_name.c_str());
     return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
@@ -147,6 +225,19 @@ inline bool IsFileExist_UTF16(const std::wstring& file_name) {
     return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
 }
 
+#else
+
+inline bool IsFileExist_ASCII(const std::string& file_name) {
+    struct stat status;
+    return stat(file_name.c_str(), &status) == 0 && S_ISREG(status.st_mode);
+}
+
+inline bool IsFileExist_UTF16(const std::wstring& file_name) {
+    return IsFileExist_ASCII(ToUTF8(file_name));
+}
+
+#endif
+
 //------------------------------------------------------------------------------
 
 class LocaleGuradianUTF8 {
@@ -155,7 +246,11 @@ public:
         const char* locale = setlocale(LC_ALL, nullptr);
         if (locale) m_locale_backup = locale;
 
+#if defined(_WIN32)
         setlocale(LC_ALL, ".utf8");
+#else
+        setlocale(LC_ALL, "C.UTF-8");
+#endif
     }
 
     virtual ~LocaleGuradianUTF8() {
@@ -169,9 +264,9 @@ private:
 inline std::string LoadFromFile_UTF8(const std::string& file_name, bool* is_success = nullptr) {
     std::string content;
 
-    FILE* file = nullptr;
+    FILE* file = OpenFile(file_name, "r");
 
-    if ((fopen_s(&file, file_name.c_str(), "r") == 0) && file) {
+    if (file) {
         char c;
         while ((c = fgetc(file)) != EOF) {
             content += c;
@@ -187,9 +282,9 @@ inline std::string LoadFromFile_UTF8(const std::string& file_name, bool* is_succ
 }
 
 inline bool SaveToFile_UTF8(const std::string& file_name, const std::string& content) {
-    FILE* file = nullptr;
+    FILE* file = OpenFile(file_name, "w");
 
-    if (fopen_s(&file, file_name.c_str(), "w") == 0 && file) {
+    if (file) {
         const int count = fprintf(file, "%s", content.c_str());
         fclose(file);
 
@@ -213,6 +308,8 @@ inline std::string ReplaceAll(const std::string& text, const std::string& old_pa
     return new_text;
 }
 
+#if defined(_WIN32)
+
 inline std::wstring GetCWD_UTF16() {
     WCHAR buffer[MAX_PATH] = {0};
     DWORD count = GetModuleFileNameW(NULL, buffer, MAX_PATH);
@@ -264,6 +361,54 @@ inline std::string GetSourceFileName_UTF8(bool is_convert_backslash_to_slash = f
     return full_path;
 }
 
+#else
+
+// Solution folder is found from path of Support.cpp, which is compiled with absolute path.
+std::string GetDefSolutionDir_UTF8();
+
+// file_name                        Path relative to solution folder, with backslashes as separators.
+// is_convert_backslash_to_slash    Ignored, slashes are always used.
+inline std::string GetSourceFileName_UTF8(bool is_convert_backslash_to_slash = false, const std::string& file_name  = "\\TrivialTestKit_Test\\src\\Tests.cpp") {
+    (void)is_convert_backslash_to_slash;
+    return GetDefSolutionDir_UTF8() + ReplaceAll(file_name, "\\", "/");
+}
+
+#endif
+
+// Removes folder with its content (if exists) and creates it empty.
+inline void RecreateFolder(const std::string& folder_name) {
+#if defined(_WIN32)
+    if (IsStdOutWideOriented()) {
+        const std::wstring folder_name_utf16 = ToUTF16(folder_name);
+        _wsystem((L"if exist " + folder_name_utf16 + L" @rd /S /Q " + folder_name_utf16).c_str());
+        _wsystem((L"mkdir " + folder_name_utf16).c_str());
+    } else {
+        system(("if exist " + folder_name + " @rd /S /Q " + folder_name).c_str());
+        system(("mkdir " + folder_name).c_str());
+    }
+#else
+    system(("rm -rf " + folder_name + " && mkdir " + folder_name).c_str());
+#endif
+}
+
+// file_name        Path with slashes as separators.
+inline void CreateEmptyFile(const std::string& file_name) {
+#if defined(_WIN32)
+    system(("echo. > " + ReplaceAll(file_name, "/", "\\")).c_str());
+#else
+    system(("touch " + file_name).c_str());
+#endif
+}
+
+// folder_name      Path with slashes as separators.
+inline void CreateFolder(const std::string& folder_name) {
+#if defined(_WIN32)
+    system(("mkdir " + ReplaceAll(folder_name, "/", "\\")).c_str());
+#else
+    system(("mkdir " + folder_name).c_str());
+#endif
+}
+
 inline void PrintIfMissmatch(const std::string& output_contnet, const std::string& expected_output_contnet) {
     if (output_contnet != expected_output_contnet) {
         puts(output_contnet.c_str());
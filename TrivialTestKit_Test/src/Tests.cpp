@@ -1,5 +1,6 @@
 #include "Tests.h"
 
+#define TTK_ALLOCATION_HOOKS
 #include "TrivialTestKit.h"
 #include "Support.h"
 
@@ -28,6 +29,8 @@
 #endif
 
 #include <set>
+#include <list>
+#include <regex>
 
 //==============================================================================
 
@@ -78,26 +81,24 @@ void Test_IsFileExist_ASCII() {
 
     // not exists
     {
-        const std::string file_url = "log\\NotExistingFile.txt";
+        const std::string file_url = "log/NotExistingFile.txt";
         assert(IsFileExist_ASCII(file_url) == false);
     }
 
     // existing
     {
-        const std::string file_url = "log\\ExistingFile.txt";
+        const std::string file_url = "log/ExistingFile.txt";
 
-        const std::string command = std::string("echo. > ") + file_url;
-        system(command.c_str());
+        CreateEmptyFile(file_url);
 
         assert(IsFileExist_ASCII(file_url));
     }
 
     // wrong type
     {
-        const std::string folder_url = "log\\NotFile";
+        const std::string folder_url = "log/NotFile";
 
-        const std::string command = std::string("mkdir ") + folder_url;
-        system(command.c_str());
+        CreateFolder(folder_url);
 
         assert(IsFileExist_ASCII(folder_url) == false);
     }
@@ -1088,6 +1089,1727 @@ void Test_TTK_RunSuccessDisable() {
     assert(output_contnet == expected_output_contnet);
 }
 
+void Test_TTK_RunOnWorkers() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_RunOnWorkers.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetNumberOfWorkers(4);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestExpectFail, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestAssertSuccessB, 0);
+        TTK_ADD_TEST(TestExpectFail, 0);
+        TTK_ADD_TEST(TestExpectSuccessA, 0);
+        TTK_ADD_TEST(TestExpectSuccessB, TTK_DISABLE);
+        TTK_ADD_TEST(TestExpectSuccessB, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetNumberOfWorkers(1);
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestAssertSuccessA\n"
+        "[test] TestExpectFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[10]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[11]) + "] [condition:300 > 300] [message:Message 2.]\n"
+        "[test] TestAssertSuccessB\n"
+        "[test] TestExpectFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[10]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[11]) + "] [condition:300 > 300] [message:Message 2.]\n"
+        "[test] TestExpectSuccessA\n"
+        "[test] TestExpectSuccessB\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 24\n"
+        "number of failed asserts        : 4\n"
+        "number of executed tests        : 6\n"
+        "number of failed tests          : 2\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+void Test_TTK_RunOnWorkersFail() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_RunOnWorkersFail.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetNumberOfWorkers(0);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestAssertFail, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestAssertSuccessB, 0);
+        TTK_ADD_TEST(TestAssertFail, 0);
+        TTK_ADD_TEST(TestExpectSuccessA, 0);
+        TTK_ADD_TEST(TestExpectSuccessB, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetNumberOfWorkers(1);
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestAssertSuccessA\n"
+        "[test] TestAssertFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[0]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "[test] TestAssertSuccessB\n"
+        "[test] TestAssertFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[0]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 12\n"
+        "number of failed asserts        : 2\n"
+        "number of executed tests        : 4\n"
+        "number of failed tests          : 2\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+void Test_TTK_RunInChildProcesses() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_RunInChildProcesses.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetProcessIsolation(true);
+        TTK_SetNumberOfWorkers(3);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestExpectFail, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestAssertSuccessB, 0);
+        TTK_ADD_TEST(TestAssertFail, 0);
+        TTK_ADD_TEST(TestExpectSuccessA, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetNumberOfWorkers(1);
+        TTK_SetProcessIsolation(false);
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestAssertSuccessA\n"
+        "[test] TestExpectFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[10]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[11]) + "] [condition:300 > 300] [message:Message 2.]\n"
+        "[test] TestAssertSuccessB\n"
+        "[test] TestAssertFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[0]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 14\n"
+        "number of failed asserts        : 3\n"
+        "number of executed tests        : 4\n"
+        "number of failed tests          : 2\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+#ifdef TTK_PROCESS_ISOLATION_AVAILABLE
+// Test function is executed in child process, so line can't be registered in g_line.
+const uint64_t g_crash_fail_line = __LINE__ + 4;
+
+void TestCrash() {
+    TTK_EXPECT(1 == 1);
+    TTK_EXPECT_M(2 == 3, "Message 1.");
+    abort();
+}
+
+void Test_TTK_RunInChildProcessesCrash() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_RunInChildProcessesCrash.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetProcessIsolation(true);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestCrash, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestAssertSuccessB, 0);
+        TTK_ADD_TEST(TestCrash, 0);
+        TTK_ADD_TEST(TestExpectSuccessA, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetProcessIsolation(false);
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestAssertSuccessA\n"
+        "[test] TestCrash\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_crash_fail_line) + "] [condition:2 == 3] [message:Message 1.]\n"
+        "    [fail] [crash:signal SIGABRT]\n"
+        "[test] TestAssertSuccessB\n"
+        "[test] TestCrash\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_crash_fail_line) + "] [condition:2 == 3] [message:Message 1.]\n"
+        "    [fail] [crash:signal SIGABRT]\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 12\n"
+        "number of failed asserts        : 4\n"
+        "number of executed tests        : 4\n"
+        "number of failed tests          : 2\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+void TestExit() {
+    TTK_EXPECT(1 == 1);
+    exit(0);
+}
+
+void Test_TTK_RunInChildProcessesAsyncOutput() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_RunInChildProcessesAsyncOutput.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetOutputMode(TTK_OUTPUT_ASYNC, 16);
+        TTK_SetProcessIsolation(true);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestExit, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestExpectSuccessA, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetProcessIsolation(false);
+        TTK_SetOutputMode(TTK_OUTPUT_DIRECT);
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestAssertSuccessA\n"
+        "[test] TestExit\n"
+        "    [fail] [crash:exit code 0]\n"
+        "[test] TestExpectSuccessA\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 8\n"
+        "number of failed asserts        : 1\n"
+        "number of executed tests        : 3\n"
+        "number of failed tests          : 1\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+// Test function is executed in child process or stuck on other thread, so line can't be registered in g_line.
+const uint64_t g_hang_fail_line = __LINE__ + 3;
+
+void TestHang() {
+    TTK_EXPECT_M(2 == 3, "Message 1.");
+    for (;;) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
+void Test_TTK_RunInChildProcessesTimeout() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_RunInChildProcessesTimeout.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetProcessIsolation(true);
+        TTK_SetTimeout(0, 500000000);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestHang, TTK_NO_ABORT | TTK_TIMEOUT_MS(100));
+        TTK_ADD_TEST(TestAssertSuccessB, 0);
+        TTK_ADD_TEST(TestHang, 0);
+        TTK_ADD_TEST(TestExpectSuccessA, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetTimeout(0, 0);
+        TTK_SetProcessIsolation(false);
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestAssertSuccessA\n"
+        "[test] TestHang\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_hang_fail_line) + "] [condition:2 == 3] [message:Message 1.]\n"
+        "    [fail] [timeout:100.000 ms]\n"
+        "[test] TestAssertSuccessB\n"
+        "[test] TestHang\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_hang_fail_line) + "] [condition:2 == 3] [message:Message 1.]\n"
+        "    [fail] [timeout:run 500.000 ms]\n"
+        "TTK Error: Run timeout (500.000 ms) has been exceeded. Number of not executed tests: 1.\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 10\n"
+        "number of failed asserts        : 4\n"
+        "number of executed tests        : 4\n"
+        "number of failed tests          : 2\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+// Watchdog terminates process, so run is executed in forked process.
+void Test_TTK_RunWatchdog() {
+    Notice();
+
+    for (const uint32_t number_of_workers : {1u, 3u}) {
+        const std::string output_file_name = "log/Out_RunWatchdog" + std::to_string(number_of_workers) + ".txt";
+
+        fflush(nullptr);
+        const pid_t pid = fork();
+        assert(pid >= 0);
+
+        if (pid == 0) {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetNumberOfWorkers(number_of_workers);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestHang, TTK_TIMEOUT_MS(100));
+            TTK_ADD_TEST(TestAssertSuccessB, 0);
+            TTK_Run();
+            _exit(0); // not reached
+        }
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n"
+            "[test] TestAssertSuccessA\n"
+            "[test] TestHang\n"
+            "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_hang_fail_line) + "] [condition:2 == 3] [message:Message 1.]\n"
+            "    [fail] [timeout:100.000 ms]\n"
+            "TTK Error: Timeout of test function has been exceeded. Number of not executed tests: 1.\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 4\n"
+            "number of failed asserts        : 2\n"
+            "number of executed tests        : 2\n"
+            "number of failed tests          : 1\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+}
+
+const uint64_t g_hang_failing_line = __LINE__ + 4;
+
+void TestHangFailing() {
+    for (;;) {
+        TTK_EXPECT(false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Stuck test function keeps failing, while watchdog displays summary.
+void Test_TTK_RunWatchdogFailing() {
+    Notice();
+
+    for (const uint32_t number_of_workers : {1u, 3u}) {
+        const std::string output_file_name = "log/Out_RunWatchdogFailing" + std::to_string(number_of_workers) + ".txt";
+
+        fflush(nullptr);
+        const pid_t pid = fork();
+        assert(pid >= 0);
+
+        if (pid == 0) {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetOutputMode(TTK_OUTPUT_BUFFERED);
+            TTK_SetNumberOfWorkers(number_of_workers);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestHangFailing, TTK_NO_ABORT | TTK_TIMEOUT_MS(100));
+            TTK_ADD_TEST(TestAssertSuccessB, 0);
+            TTK_ADD_TEST(TestExpectSuccessA, 0);
+            TTK_Run();
+            _exit(0); // not reached
+        }
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+
+        // All displayed fails are counted, and nothing is displayed after summary.
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+
+        const std::string head = 
+            "--- TEST ---\n"
+            "[test] TestAssertSuccessA\n"
+            "[test] TestHangFailing\n";
+        assert(output_contnet.compare(0, head.length(), head) == 0);
+
+        const std::regex summary_regex(
+            "    \\[fail\\] \\[timeout:100\\.000 ms\\]\n"
+            "TTK Error: Timeout of test function has been exceeded\\. Number of not executed tests: 2\\.\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 4\n"
+            "number of failed asserts        : ([0-9]+)\n"
+            "number of executed tests        : 2\n"
+            "number of failed tests          : 1\n$");
+        std::smatch match;
+        assert(std::regex_search(output_contnet, match, summary_regex));
+
+        const std::string fail = "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_hang_failing_line) + "] [condition:false]\n";
+        uint64_t number_of_fails = 0;
+        for (size_t index = output_contnet.find(fail); index != std::string::npos; index = output_contnet.find(fail, index + 1)) number_of_fails += 1;
+
+        assert(number_of_fails > 0);
+        assert(head.length() + number_of_fails * fail.length() == size_t(match.position(0)));
+        assert(std::stoull(match[1].str()) == number_of_fails + 1);
+    }
+}
+
+void TestCrashBySignal() {
+    raise(SIGSEGV);
+}
+
+// Gathered communicates are written by signal handler, so crash is executed in forked process.
+void Test_TTK_OutputModeCrash() {
+    Notice();
+
+    const TTK_OutputMode modes[] = {TTK_OUTPUT_BUFFERED, TTK_OUTPUT_ASYNC};
+
+    for (const TTK_OutputMode mode : modes) {
+        const std::string output_file_name = "log/Out_OutputModeCrash" + std::to_string(mode) + ".txt";
+
+        fflush(nullptr);
+        const pid_t pid = fork();
+        assert(pid >= 0);
+
+        if (pid == 0) {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetOutputMode(mode, 1 << 16);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestCrashBySignal, 0);
+            TTK_Run();
+            _exit(0); // not reached
+        }
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n"
+            "[test] TestAssertSuccessA\n"
+            "[test] TestCrashBySignal\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+}
+#endif
+
+void Test_TTK_RunShard() {
+    Notice();
+
+    const char* names[] = {"TestAssertSuccessA", "TestAssertSuccessB", "TestExpectSuccessA", "TestExpectSuccessB"};
+
+    for (uint32_t shard_index = 0; shard_index < 2; ++shard_index) {
+        const std::string output_file_name = "log/Out_RunShard" + std::to_string(shard_index) + ".txt";
+        {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetShard(shard_index, 2);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestAssertSuccessB, 0);
+            TTK_ADD_TEST(TestExpectSuccessA, 0);
+            TTK_ADD_TEST(TestExpectSuccessB, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetShard(0, 0);
+        }
+
+        std::string tests_contnet;
+        uint64_t number_of_tests = 0;
+
+        for (const char* name : names) {
+            if (TTK_HashName(name) % 2 == shard_index) {
+                tests_contnet += std::string("[test] ") + name + "\n";
+                number_of_tests += 1;
+            }
+        }
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n" +
+            tests_contnet +
+            "--- TEST SUCCESS ---\n"
+            "number of executed asserts      : " + std::to_string(number_of_tests * 4) + "\n"
+            "number of failed asserts        : 0\n"
+            "number of executed tests        : " + std::to_string(number_of_tests) + "\n"
+            "number of failed tests          : 0\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+}
+
+void Test_TTK_TestRecords() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_TestRecords.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetTimeReport(true, 2);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestExpectFail, 0);
+        TTK_ADD_TEST(TestExpectSuccessB, 0);
+        TTK_Run();
+
+        const std::vector<TTK_TestRecord>& records = TTK_GetTestRecords();
+
+        assert(records.size() == 3);
+        assert(strcmp(records[0].name, "TestAssertSuccessA") == 0 && !records[0].is_fail);
+        assert(strcmp(records[1].name, "TestExpectFail") == 0 && records[1].is_fail);
+        assert(strcmp(records[2].name, "TestExpectSuccessB") == 0 && !records[2].is_fail);
+        assert(TTK_GetTotalTime() >= records[0].duration + records[1].duration + records[2].duration);
+
+        TTK_Clear();
+        TTK_SetTimeReport(false, 0);
+
+        assert(TTK_GetTestRecords().empty());
+    }
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+
+    size_t number_of_time_lines = 0;
+    for (size_t pos = 0; (pos = output_contnet.find("    [time] ", pos)) != std::string::npos; ++pos) number_of_time_lines += 1;
+
+    assert(number_of_time_lines == 3);
+    assert(output_contnet.find("total time                      : ") != std::string::npos);
+    assert(output_contnet.find("slowest tests                   :\n") != std::string::npos);
+}
+
+void BenchmarkSum(TTK_BenchmarkState& state) {
+    uint64_t values[64] = {};
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        for (uint64_t& value : values) value += 1;
+        state.ResumeTiming();
+
+        uint64_t sum = 0;
+        for (uint64_t value : values) sum += value;
+        TTK_DoNotOptimize(sum);
+        TTK_ClobberMemory();
+    }
+    g_test_finish_counter += 1;
+}
+
+void BenchmarkNoLoop(TTK_BenchmarkState&) {
+    g_test_finish_counter += 1;
+}
+
+void Test_TTK_Benchmark() {
+    Notice();
+
+    g_test_finish_counter = 0;
+    const std::string output_file_name = "log/Out_Benchmark.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetBenchmarkConfig(100000, 3);
+        TTK_ADD_BENCHMARK(BenchmarkSum, 0);
+        TTK_ADD_BENCHMARK(BenchmarkNoLoop, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetBenchmarkConfig(10000000, 10);
+    }
+    assert(g_test_finish_counter >= 5);
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_begin = 
+        "--- TEST ---\n"
+        "[test] BenchmarkSum\n"
+        "    [benchmark] [iterations:";
+    const std::string expected_output_end = 
+        "[test] BenchmarkNoLoop\n"
+        "    [benchmark] [error:benchmark function has not finished iterations]\n"
+        "--- TEST SUCCESS ---\n"
+        "number of executed asserts      : 0\n"
+        "number of failed asserts        : 0\n"
+        "number of executed tests        : 2\n"
+        "number of failed tests          : 0\n";
+
+    assert(output_contnet.find(expected_output_begin) == 0);
+    assert(output_contnet.find("] [samples:3] [mean:") != std::string::npos);
+    assert(output_contnet.find(expected_output_end) == output_contnet.length() - expected_output_end.length());
+}
+
+void Test_TTK_OutputMode() {
+    Notice();
+
+    const TTK_OutputMode modes[] = {TTK_OUTPUT_BUFFERED, TTK_OUTPUT_ASYNC};
+
+    for (const TTK_OutputMode mode : modes) {
+        for (const size_t buffer_size : {size_t(16), size_t(1 << 16)}) {
+            const std::string output_file_name = "log/Out_OutputMode" + std::to_string(mode) + "_" + std::to_string(buffer_size) + ".txt";
+            {
+                Output output = Output(output_file_name);
+
+                TTK_SetOutput(output.Access());
+                TTK_SetOutputMode(mode, buffer_size);
+                TTK_ADD_TEST(TestAssertSuccessA, 0);
+                TTK_ADD_TEST(TestAssertFail, TTK_NO_ABORT);
+                TTK_ADD_TEST(TestExpectSuccessA, 0);
+                TTK_Run();
+                TTK_Clear();
+                TTK_SetOutputMode(TTK_OUTPUT_DIRECT);
+            }
+
+            const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+            const std::string expected_output_contnet = 
+                "--- TEST ---\n"
+                "[test] TestAssertSuccessA\n"
+                "[test] TestAssertFail\n"
+                "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[0]) + "] [condition:200 > 200] [message:Message 1.]\n"
+                "[test] TestExpectSuccessA\n"
+                "--- TEST FAIL ---\n"
+                "number of executed asserts      : 10\n"
+                "number of failed asserts        : 1\n"
+                "number of executed tests        : 3\n"
+                "number of failed tests          : 1\n";
+            PrintIfMissmatch(output_contnet, expected_output_contnet);
+            assert(output_contnet == expected_output_contnet);
+        }
+    }
+}
+
+void Test_TTK_DecodeUTF8() {
+    Notice();
+
+    auto Decode = [](const std::string& text) -> std::vector<uint32_t> {
+        std::vector<uint32_t> code_points;
+        for (size_t index = 0; index < text.size();) {
+            uint32_t code_point = 0;
+            index += TTK_DecodeUTF8(text.data() + index, text.size() - index, code_point);
+            code_points.push_back(code_point);
+        }
+        return code_points;
+    };
+
+    assert(Decode("") == std::vector<uint32_t>({}));
+    assert(Decode(u8"a\u0444\u20AC\U0001D11E") == std::vector<uint32_t>({0x61, 0x444, 0x20AC, 0x1D11E}));
+
+    // invalid sequences
+    assert(Decode("\xFF" "a") == std::vector<uint32_t>({0xFFFD, 0x61}));           // invalid lead byte
+    assert(Decode("\xC0\x80") == std::vector<uint32_t>({0xFFFD, 0xFFFD}));         // overlong encoding
+    assert(Decode("\xE2\x82" "a") == std::vector<uint32_t>({0xFFFD, 0x61}));       // truncated sequence
+    assert(Decode("\xED\xA0\x80") == std::vector<uint32_t>({0xFFFD}));             // surrogate
+    assert(Decode("\xE2\x82") == std::vector<uint32_t>({0xFFFD}));                 // sequence cut by end of text
+}
+
+void Test_TTK_Reporters() {
+    Notice();
+
+    for (const uint32_t number_of_workers : {1u, 3u}) {
+        const std::string junit_file_name   = "log/Out_ReportersJUnit" + std::to_string(number_of_workers) + ".xml";
+        const std::string json_file_name    = "log/Out_ReportersJSON" + std::to_string(number_of_workers) + ".jsonl";
+        {
+            Output junit_output = Output(junit_file_name);
+            Output json_output  = Output(json_file_name);
+
+            TTK_JUnitReporter       junit_reporter(junit_output.Access());
+            TTK_JSONLinesReporter   json_reporter(json_output.Access());
+
+            TTK_SetOutput(nullptr);
+            TTK_SetNumberOfWorkers(number_of_workers);
+            TTK_AddReporter(&junit_reporter);
+            TTK_AddReporter(&json_reporter);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestAssertFail, TTK_NO_ABORT);
+            TTK_ADD_TEST(TestExpectSuccessA, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetNumberOfWorkers(1);
+        }
+
+        // Durations differ between executions.
+        const std::string junit_contnet = std::regex_replace(LoadFromFile_UTF8(junit_file_name), std::regex("time=\"[0-9.]+\""), "time=\"T\"");
+        const std::string expected_junit_contnet = 
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<testsuites>\n"
+            "  <testsuite name=\"TrivialTestKit\">\n"
+            "    <testcase classname=\"TrivialTestKit\" name=\"TestAssertSuccessA\" time=\"T\"/>\n"
+            "    <testcase classname=\"TrivialTestKit\" name=\"TestAssertFail\" time=\"T\">\n"
+            "      <failure message=\"" + GetSourceFileName_UTF8() + ":" + std::to_string(g_line[0]) + ": 200 &gt; 200: Message 1.\">" 
+                + GetSourceFileName_UTF8() + ":" + std::to_string(g_line[0]) + ": 200 &gt; 200: Message 1.\n</failure>\n"
+            "    </testcase>\n"
+            "    <testcase classname=\"TrivialTestKit\" name=\"TestExpectSuccessA\" time=\"T\"/>\n"
+            "  </testsuite>\n"
+            "</testsuites>\n";
+        PrintIfMissmatch(junit_contnet, expected_junit_contnet);
+        assert(junit_contnet == expected_junit_contnet);
+
+        const std::string json_file = std::regex_replace(GetSourceFileName_UTF8(), std::regex("\\\\"), "\\\\");
+        const std::string json_contnet = std::regex_replace(LoadFromFile_UTF8(json_file_name), std::regex("\"duration_ns\":[0-9]+"), "\"duration_ns\":T");
+        const std::string expected_json_contnet = 
+            "{\"event\":\"run_begin\",\"tests\":3}\n"
+            "{\"event\":\"test_begin\",\"name\":\"TestAssertSuccessA\"}\n"
+            "{\"event\":\"test_end\",\"name\":\"TestAssertSuccessA\",\"result\":\"success\",\"executed_asserts\":4,\"failed_asserts\":0,\"duration_ns\":T}\n"
+            "{\"event\":\"test_begin\",\"name\":\"TestAssertFail\"}\n"
+            "{\"event\":\"assert_fail\",\"name\":\"TestAssertFail\",\"file\":\"" + json_file + "\",\"line\":" + std::to_string(g_line[0]) + ",\"condition\":\"200 > 200\",\"message\":\"Message 1.\"}\n"
+            "{\"event\":\"test_end\",\"name\":\"TestAssertFail\",\"result\":\"fail\",\"executed_asserts\":2,\"failed_asserts\":1,\"duration_ns\":T}\n"
+            "{\"event\":\"test_begin\",\"name\":\"TestExpectSuccessA\"}\n"
+            "{\"event\":\"test_end\",\"name\":\"TestExpectSuccessA\",\"result\":\"success\",\"executed_asserts\":4,\"failed_asserts\":0,\"duration_ns\":T}\n"
+            "{\"event\":\"run_end\",\"result\":\"fail\",\"executed_asserts\":10,\"failed_asserts\":1,\"executed_tests\":3,\"failed_tests\":1,\"duration_ns\":T}\n";
+        PrintIfMissmatch(json_contnet, expected_json_contnet);
+        assert(json_contnet == expected_json_contnet);
+    }
+}
+
+void Test_TTK_MatchGlob() {
+    Notice();
+
+    assert(TTK_MatchGlob("", ""));
+    assert(TTK_MatchGlob("*", ""));
+    assert(TTK_MatchGlob("*", "TestA"));
+    assert(TTK_MatchGlob("TestA", "TestA"));
+    assert(!TTK_MatchGlob("TestA", "TestAB"));
+    assert(!TTK_MatchGlob("TestAB", "TestA"));
+    assert(TTK_MatchGlob("Test?", "TestA"));
+    assert(!TTK_MatchGlob("Test?", "Test"));
+    assert(TTK_MatchGlob("Test*B", "TestAB"));
+    assert(TTK_MatchGlob("Test*B", "TestBAB"));
+    assert(!TTK_MatchGlob("Test*B", "TestBA"));
+    assert(TTK_MatchGlob("*A*B*", "xxAyyBzz"));
+}
+
+void Test_TTK_RunFilter() {
+    Notice();
+
+    struct Case {
+        std::vector<std::pair<std::string, int>>    filters;    // 0 - include, 1 - exclude, 2 - include regex, 3 - exclude regex
+        std::vector<std::string>                    names;      // expected to be executed
+    };
+
+    const std::vector<Case> cases = {
+        {{}, {"TestAssertSuccessA", "TestAssertSuccessB", "TestExpectSuccessA", "TestExpectSuccessB"}},
+        {{{"TestAssertSuccessB", 0}}, {"TestAssertSuccessB"}},
+        {{{"TestAssert*", 0}, {"*B", 1}}, {"TestAssertSuccessA"}},
+        {{{"*B", 1}}, {"TestAssertSuccessA", "TestExpectSuccessA"}},
+        {{{"TestExpect.*", 2}}, {"TestExpectSuccessA", "TestExpectSuccessB"}},
+        {{{"Test(Assert|Expect)SuccessA", 2}, {"TestExpectSuccessB", 0}}, {"TestAssertSuccessA", "TestExpectSuccessA", "TestExpectSuccessB"}},
+        {{{"Tests?Assert.*", 2}, {".*A", 3}}, {"TestAssertSuccessB"}},
+        {{{"NoSuchTest*", 0}}, {}},
+    };
+
+    for (size_t case_index = 0; case_index < cases.size(); ++case_index) {
+        const std::string output_file_name = "log/Out_RunFilter" + std::to_string(case_index) + ".txt";
+        {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            for (const std::pair<std::string, int>& filter : cases[case_index].filters) {
+                assert(TTK_AddFilter(filter.first.c_str(), filter.second % 2 == 1, filter.second >= 2));
+            }
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestAssertSuccessB, 0);
+            TTK_ADD_TEST(TestExpectSuccessA, 0);
+            TTK_ADD_TEST(TestExpectSuccessB, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_ClearFilters();
+        }
+
+        std::string tests_contnet;
+        for (const std::string& name : cases[case_index].names) tests_contnet += "[test] " + name + "\n";
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n" +
+            tests_contnet +
+            "--- TEST SUCCESS ---\n"
+            "number of executed asserts      : " + std::to_string(cases[case_index].names.size() * 4) + "\n"
+            "number of failed asserts        : 0\n"
+            "number of executed tests        : " + std::to_string(cases[case_index].names.size()) + "\n"
+            "number of failed tests          : 0\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+
+    assert(!TTK_AddFilter("Test(", false, true));
+}
+
+void Test_TTK_Register() {
+    Notice();
+
+    TTK_Register tests;
+    assert(tests.GetNumberOfTests() == 0);
+    assert(tests.GetCapacity() == 0);
+
+    tests.Reserve(5000);
+    const TTK_Register::SizeType capacity = tests.GetCapacity();
+    assert(capacity >= 5000);
+
+    static const char* const s_names[] = {"TestA", "TestB", "TestC"};
+
+    tests.AddTest({TestAssertSuccessA, s_names[0], 0, nullptr, nullptr, 0, nullptr});
+    const TTK_TestData* first_test = &tests.ToTest(0);
+
+    for (uint64_t index = 1; index < 100000; ++index) {
+        assert(tests.AddTest({TestAssertSuccessA, s_names[index % 3], index, nullptr, nullptr, 0, nullptr}));
+        if (index < 5000) assert(tests.GetCapacity() == capacity); // no allocation within reserved capacity
+    }
+
+    assert(tests.GetNumberOfTests() == 100000);
+    assert(&tests.ToTest(0) == first_test);  // address is stable
+    for (uint64_t index = 0; index < 100000; ++index) {
+        assert(tests.ToTest(index).mode == index && tests.ToTest(index).name == s_names[index % 3]);
+    }
+
+    tests.Clear();
+    assert(tests.GetNumberOfTests() == 0);
+    assert(tests.GetCapacity() == 0);
+}
+
+static std::atomic<int> g_case_sum(0);
+
+static const uint64_t s_param_fail_line = __LINE__ + 4; // constant, since cases might be executed by workers
+
+TTK_TEST_P(TestParamValue, int) {
+    g_case_sum += param;
+    TTK_EXPECT(param != 3);
+}
+
+TTK_TEST_P(TestParamRange, double) {
+    g_case_sum += int(param * 10);
+    TTK_ASSERT(param < 1);
+}
+
+TTK_TEST_P(TestParamGenerator, std::string) {
+    g_case_sum += int(param.size());
+    TTK_ASSERT(param.size() >= 1);
+}
+
+void Test_TTK_ParameterizedTests() {
+    Notice();
+
+    for (const uint32_t number_of_workers : {1u, 3u}) {
+        const std::string output_file_name = "log/Out_ParameterizedTests" + std::to_string(number_of_workers) + ".txt";
+        g_case_sum = 0;
+        {
+            Output output = Output(output_file_name);
+
+            const std::vector<int> values = {1, 2, 3, 4};
+
+            TTK_SetOutput(output.Access());
+            TTK_SetNumberOfWorkers(number_of_workers);
+            TTK_ADD_TEST_VALUES(TestParamValue, values, TTK_NO_ABORT);
+            TTK_ADD_TEST_RANGE(TestParamRange, 0, 0.5, 0.125, 0);
+            TTK_ADD_TEST_GENERATOR(TestParamGenerator, [](uint64_t case_index) { return std::string(case_index + 1, 'x'); }, 3, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetNumberOfWorkers(1);
+        }
+
+        assert(g_case_sum == (1 + 2 + 3 + 4) + (0 + 1 + 2 + 3) + (1 + 2 + 3));
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n"
+            "[test] TestParamValue/0\n"
+            "[test] TestParamValue/1\n"
+            "[test] TestParamValue/2\n"
+            "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(s_param_fail_line) + "] [condition:param != 3]\n"
+            "[test] TestParamValue/3\n"
+            "[test] TestParamRange/0\n"
+            "[test] TestParamRange/1\n"
+            "[test] TestParamRange/2\n"
+            "[test] TestParamRange/3\n"
+            "[test] TestParamGenerator/0\n"
+            "[test] TestParamGenerator/1\n"
+            "[test] TestParamGenerator/2\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 11\n"
+            "number of failed asserts        : 1\n"
+            "number of executed tests        : 11\n"
+            "number of failed tests          : 1\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+}
+
+// Disabled, so they are executed only when added explicitly (not in in place tests).
+static const uint64_t s_property_fail_line = __LINE__ + 3;
+
+TTK_PROPERTY(TestPropertyIntFail, TTK_GenInt<int>(0, 1000000), TTK_DISABLE) {
+    TTK_ASSERT(param < 100);
+}
+
+TTK_PROPERTY(TestPropertyVectorFail, TTK_GenVector(TTK_GenInt<int>(0, 9), 0, 20), TTK_DISABLE) {
+    TTK_ASSERT(std::find(param.begin(), param.end(), 7) == param.end());
+}
+
+TTK_PROPERTY(TestPropertyTupleFail, TTK_GenTuple(TTK_GenInt<int>(0, 100), TTK_GenString(0, 10), TTK_GenBool()), TTK_DISABLE) {
+    TTK_EXPECT_M(std::get<0>(param) < 10 || std::get<1>(param).size() < 2 || !std::get<2>(param), "Message 1.");
+}
+
+TTK_PROPERTY(TestPropertyRealSuccess, TTK_GenReal<double>(-1.0, 1.0), TTK_DISABLE) {
+    TTK_ASSERT(param >= -1.0 && param <= 1.0);
+}
+
+void Test_TTK_Property() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_Property.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetPropertyConfig(500, 0, 7);
+        TTK_ADD_TEST(TestPropertyIntFail, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestPropertyVectorFail, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestPropertyTupleFail, TTK_NO_ABORT);
+        TTK_ADD_TEST(TestPropertyRealSuccess, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetPropertyConfig(1000, 0, 0);
+    }
+
+    // Case and number of shrink steps depend on sequence of random values.
+    const std::string output_contnet = std::regex_replace(LoadFromFile_UTF8(output_file_name), std::regex("case: [0-9]+, shrink steps: [0-9]+|asserts      : [0-9]+\n(?=number of failed)"), "X");
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestPropertyIntFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(s_property_fail_line) + "] [condition:param < 100] [message:falsified by counterexample: 100 (seed: 7, X)]\n"
+        "[test] TestPropertyVectorFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(s_property_fail_line + 4) + "] [condition:std::find(param.begin(), param.end(), 7) == param.end()] [message:falsified by counterexample: [7] (seed: 7, X)]\n"
+        "[test] TestPropertyTupleFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(s_property_fail_line + 8) + "] [condition:std::get<0>(param) < 10 || std::get<1>(param).size() < 2 || !std::get<2>(param)] [message:Message 1., falsified by counterexample: (10, \"  \", true) (seed: 7, X)]\n"
+        "[test] TestPropertyRealSuccess\n"
+        "--- TEST FAIL ---\n"
+        "number of executed X"
+        "number of failed asserts        : 3\n"
+        "number of executed tests        : 4\n"
+        "number of failed tests          : 3\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+void TestNoAllocation() {
+    int value = 1;
+    TTK_ASSERT_NO_ALLOC { value += 1; }
+    TTK_ASSERT(value == 2);
+}
+
+void TestAllocation() {
+    std::vector<int> values(100);
+    TTK_DoNotOptimize(values.data());
+}
+
+static const uint64_t s_max_allocs_fail_line = __LINE__ + 2;
+void TestMaxAllocsFail() {
+    TTK_ASSERT_MAX_ALLOCS(1) {
+        int* first  = new int[4];
+        int* second = new int[4];
+        TTK_DoNotOptimize(first);
+        TTK_DoNotOptimize(second);
+        delete[] first;
+        delete[] second;
+    }
+    g_test_finish_counter += 1;
+}
+
+void Test_TTK_Allocations() {
+    Notice();
+
+    g_test_finish_counter = 0;
+    const std::string output_file_name = "log/Out_Allocations.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetAllocationReport(true);
+        TTK_ADD_TEST(TestNoAllocation, 0);
+        TTK_ADD_TEST(TestAllocation, 0);
+        TTK_ADD_TEST(TestMaxAllocsFail, 0);
+        TTK_Run();
+
+        const std::vector<TTK_TestRecord>& records = TTK_GetTestRecords();
+
+        assert(records.size() == 3);
+        assert(records[0].number_of_allocations == 0 && records[0].peak_allocated_bytes == 0);
+        assert(records[1].number_of_allocations == 1 && records[1].allocated_bytes >= 100 * sizeof(int));
+        assert(records[1].peak_allocated_bytes == records[1].allocated_bytes);
+        assert(records[2].number_of_allocations == 2 && records[2].is_fail);
+
+        TTK_Clear();
+        TTK_SetAllocationReport(false);
+    }
+    assert(g_test_finish_counter == 0);
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_fail = 
+        "[test] TestMaxAllocsFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(s_max_allocs_fail_line) + "] [condition:number of allocations <= 1] [message:number of allocations: 2, allocated bytes: ";
+
+    assert(output_contnet.find(expected_fail) != std::string::npos);
+    assert(output_contnet.find("number of allocations           : 3\n") != std::string::npos);
+    assert(output_contnet.find(" (TestAllocation)\n") != std::string::npos);
+}
+
+static const uint64_t s_not_slower_line = __LINE__ + 3;
+void TestNotSlower() {
+    uint64_t values[16] = {};
+    TTK_ASSERT_NOT_SLOWER("sum of 16 values", 1.0) {
+        uint64_t sum = 0;
+        for (uint64_t& value : values) sum += ++value;
+        TTK_DoNotOptimize(sum);
+    }
+    g_test_finish_counter += 1;
+}
+
+// Runs TestNotSlower with given mode of baselines. Returns output with masked times.
+std::string RunTestNotSlower(const std::string& baseline_file_name, TTK_BaselineMode mode, bool is_process_isolation) {
+    const std::string output_file_name = "log/Out_Baselines.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_SetBenchmarkConfig(100000, 3);
+        TTK_SetBaseline(baseline_file_name.c_str(), mode);
+        TTK_SetProcessIsolation(is_process_isolation);
+        TTK_ADD_TEST(TestNotSlower, 0);
+        TTK_Run();
+        TTK_Clear();
+        TTK_SetProcessIsolation(false);
+        TTK_SetBaseline(nullptr, TTK_BASELINE_CHECK);
+        TTK_SetBenchmarkConfig(10000000, 10);
+    }
+    return std::regex_replace(LoadFromFile_UTF8(output_file_name), std::regex("time:[0-9.]+ ns|time: [0-9.]+ ns"), "time:T");
+}
+
+void Test_TTK_Baselines() {
+    Notice();
+
+    const std::string baseline_file_name = "log/Baselines.txt";
+    const std::regex recorded_content("[0-9]+\\.[0-9]{3} other\n[0-9]+\\.[0-9]{3} sum of 16 values\n");
+    remove(baseline_file_name.c_str());
+
+    g_test_finish_counter = 0;
+    {
+        const std::string output_contnet = RunTestNotSlower(baseline_file_name, TTK_BASELINE_CHECK, false);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n"
+            "[test] TestNotSlower\n"
+            "    [baseline] [key:sum of 16 values] [time:T] [no baseline]\n"
+            "--- TEST SUCCESS ---\n"
+            "number of executed asserts      : 1\n"
+            "number of failed asserts        : 0\n"
+            "number of executed tests        : 1\n"
+            "number of failed tests          : 0\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+
+        bool is_success = true;
+        LoadFromFile_UTF8(baseline_file_name, &is_success);
+        assert(!is_success);
+    }
+    {
+        assert(SaveToFile_UTF8(baseline_file_name, "1.000 other\n"));
+
+        const std::string output_contnet = RunTestNotSlower(baseline_file_name, TTK_BASELINE_RECORD, false);
+        assert(output_contnet.find("    [baseline] [key:sum of 16 values] [time:T] [recorded]\n") != std::string::npos);
+        assert(std::regex_match(LoadFromFile_UTF8(baseline_file_name), recorded_content));
+    }
+    {
+        assert(SaveToFile_UTF8(baseline_file_name, "0.001 sum of 16 values\n1.000 other\n"));
+
+        const std::string output_contnet = RunTestNotSlower(baseline_file_name, TTK_BASELINE_CHECK, false);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n"
+            "[test] TestNotSlower\n"
+            "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(s_not_slower_line) + "] [condition:time <= baseline * (1 + 1.0)] [message:key: sum of 16 values, time:T, baseline: 0.001 ns]\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 1\n"
+            "number of failed asserts        : 1\n"
+            "number of executed tests        : 1\n"
+            "number of failed tests          : 1\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+        assert(LoadFromFile_UTF8(baseline_file_name) == "0.001 sum of 16 values\n1.000 other\n");
+    }
+    {
+        const std::string output_contnet = RunTestNotSlower(baseline_file_name, TTK_BASELINE_UPDATE, false);
+        assert(output_contnet.find("    [baseline] [key:sum of 16 values] [time:T] [recorded]\n") != std::string::npos);
+        assert(std::regex_match(LoadFromFile_UTF8(baseline_file_name), recorded_content));
+    }
+#ifdef TTK_PROCESS_ISOLATION_AVAILABLE
+    {
+        assert(SaveToFile_UTF8(baseline_file_name, "1.000 other\n"));
+
+        const std::string output_contnet = RunTestNotSlower(baseline_file_name, TTK_BASELINE_RECORD, true);
+        assert(output_contnet.find("    [baseline] [key:sum of 16 values] [time:T] [recorded]\n") != std::string::npos);
+        assert(std::regex_match(LoadFromFile_UTF8(baseline_file_name), recorded_content));
+    }
+#endif
+    {
+        // folder can not be read as file of baselines, which is reported only when baselines are looked up
+        const std::string output_file_name = "log/Out_Baselines.txt";
+        {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetBaseline("log", TTK_BASELINE_CHECK);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetBaseline(nullptr, TTK_BASELINE_CHECK);
+        }
+        assert(LoadFromFile_UTF8(output_file_name).find("TTK Error") == std::string::npos);
+
+        const std::string output_contnet = RunTestNotSlower("log", TTK_BASELINE_CHECK, false);
+        assert(output_contnet.find("TTK Error: Can not load baselines from file: log\n") != std::string::npos);
+    }
+    assert(g_test_finish_counter == 5); // not counted in child process
+}
+
+// Runs test functions with given mode of result cache. Returns names of executed test functions.
+std::string RunWithResultCache(const std::string& cache_file_name, TTK_ResultCacheMode mode) {
+    std::string names;
+    {
+        Output output = Output("log/Out_ResultCache.txt");
+
+        TTK_SetOutput(output.Access());
+        TTK_SetResultCache(cache_file_name.c_str(), mode);
+        TTK_ADD_TEST(TestAssertSuccessA, 0);
+        TTK_ADD_TEST(TestExpectFail, 0);
+        TTK_ADD_TEST(TestExpectSuccessB, 0);
+        TTK_Run();
+
+        for (const TTK_TestRecord& record : TTK_GetTestRecords()) names += std::string(record.name) + " ";
+
+        TTK_Clear();
+        TTK_SetResultCache(nullptr, TTK_CACHE_RUN_ALL);
+    }
+    return names;
+}
+
+void Test_TTK_ResultCache() {
+    Notice();
+
+    const std::string cache_file_name = "log/ResultCache.txt";
+    remove(cache_file_name.c_str());
+
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_FAILED) == "TestAssertSuccessA TestExpectFail TestExpectSuccessB ");
+
+    const std::string identity = "[0-9a-f]+-[0-9a-f]+|unknown";
+    const std::regex cache_content(
+        "TTK_RESULT_CACHE 1\n"
+        "P [0-9]+ (" + identity + ") TestAssertSuccessA\n"
+        "F [0-9]+ (" + identity + ") TestExpectFail\n"
+        "P [0-9]+ (" + identity + ") TestExpectSuccessB\n");
+    assert(std::regex_match(LoadFromFile_UTF8(cache_file_name), cache_content));
+
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_FAILED)        == "TestExpectFail ");
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_FAILED_FIRST)      == "TestExpectFail TestAssertSuccessA TestExpectSuccessB ");
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_INCREMENTAL)   == "TestExpectFail ");
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_ALL)           == "TestAssertSuccessA TestExpectFail TestExpectSuccessB ");
+
+    // results of other binary, and of test function which doesn't exist anymore
+    assert(SaveToFile_UTF8(cache_file_name, 
+        "TTK_RESULT_CACHE 1\n"
+        "P 10 0-0 TestAssertSuccessA\n"
+        "F 10 0-0 TestExpectSuccessB\n"
+        "F 10 0-0 TestRemoved\n"));
+
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_FAILED)        == "TestExpectSuccessB ");
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_INCREMENTAL)   == "TestAssertSuccessA TestExpectFail ");
+
+    const std::string content = LoadFromFile_UTF8(cache_file_name);
+    assert(content.find("P 10 0-0 TestAssertSuccessA\n") == std::string::npos);
+    assert(content.find("F 10 0-0 TestRemoved\n") != std::string::npos);
+
+    // all cached test functions have passed, so all are executed
+    assert(SaveToFile_UTF8(cache_file_name, "TTK_RESULT_CACHE 1\nP 10 0-0 TestExpectFail\n"));
+    assert(RunWithResultCache(cache_file_name, TTK_CACHE_RUN_FAILED)        == "TestAssertSuccessA TestExpectFail TestExpectSuccessB ");
+}
+
+void TestWaitForCancel() {
+    const uint64_t begin_time = TTK_GetTime();
+    while (!TTK_IsCancelled() && TTK_GetTime() - begin_time < 10000000000ull) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    TTK_EXPECT(TTK_IsCancelled());
+}
+
+void Test_TTK_MaxFailures() {
+    Notice();
+
+    const std::string output_file_name = "log/Out_MaxFailures.txt";
+    const std::string expect_fail_output = 
+        "[test] TestExpectFail\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[10]) + "] [condition:200 > 200] [message:Message 1.]\n"
+        "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[11]) + "] [condition:300 > 300] [message:Message 2.]\n";
+
+    // limit of failed asserts, reached by second test function
+    {
+        {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetMaxFailures(0, 3);
+            TTK_ADD_TEST(TestExpectFail, 0);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestExpectFail, 0);
+            TTK_ADD_TEST(TestAssertSuccessB, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetMaxFailures(0, 0);
+        }
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n" + 
+            expect_fail_output + 
+            "[test] TestAssertSuccessA\n" + 
+            expect_fail_output + 
+            "TTK Error: Limit of failures has been reached. Number of not executed tests: 1.\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 12\n"
+            "number of failed asserts        : 4\n"
+            "number of executed tests        : 3\n"
+            "number of failed tests          : 2\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+
+    // limit of failed test functions, cancellation reaches test function executed by other worker
+    {
+        const uint64_t begin_time = TTK_GetTime();
+        {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetNumberOfWorkers(2);
+            TTK_SetMaxFailures(1, 0);
+            TTK_ADD_TEST(TestWaitForCancel, 0);
+            TTK_ADD_TEST(TestExpectFail, 0);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_ADD_TEST(TestAssertSuccessB, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetMaxFailures(0, 0);
+            TTK_SetNumberOfWorkers(1);
+        }
+        assert(TTK_GetTime() - begin_time < 5000000000ull);
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n"
+            "[test] TestWaitForCancel\n" + 
+            expect_fail_output + 
+            "TTK Error: Limit of failures has been reached. Number of not executed tests: 2.\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 5\n"
+            "number of failed asserts        : 2\n"
+            "number of executed tests        : 2\n"
+            "number of failed tests          : 1\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+
+#ifdef TTK_PROCESS_ISOLATION_AVAILABLE
+    // child process of executed test function is killed, and its test function isn't displayed
+    {
+        const uint64_t begin_time = TTK_GetTime();
+        {
+            Output output = Output(output_file_name);
+
+            TTK_SetOutput(output.Access());
+            TTK_SetNumberOfWorkers(2);
+            TTK_SetProcessIsolation(true);
+            TTK_SetMaxFailures(1, 0);
+            TTK_ADD_TEST(TestHang, 0);
+            TTK_ADD_TEST(TestExpectFail, 0);
+            TTK_ADD_TEST(TestAssertSuccessA, 0);
+            TTK_Run();
+            TTK_Clear();
+            TTK_SetMaxFailures(0, 0);
+            TTK_SetProcessIsolation(false);
+            TTK_SetNumberOfWorkers(1);
+        }
+        assert(TTK_GetTime() - begin_time < 5000000000ull);
+
+        const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+        const std::string expected_output_contnet = 
+            "--- TEST ---\n" + 
+            expect_fail_output + 
+            "TTK Error: Limit of failures has been reached. Number of not executed tests: 2.\n"
+            "--- TEST FAIL ---\n"
+            "number of executed asserts      : 4\n"
+            "number of failed asserts        : 2\n"
+            "number of executed tests        : 1\n"
+            "number of failed tests          : 1\n";
+        PrintIfMissmatch(output_contnet, expected_output_contnet);
+        assert(output_contnet == expected_output_contnet);
+    }
+#endif
+}
+
+// Runs test functions ordered by cached durations. Returns names of executed test functions.
+std::string RunLongestFirst(const std::string& cache_file_name, TTK_ResultCacheMode mode, uint64_t keep_order_mode) {
+    std::string names;
+    {
+        Output output = Output("log/Out_LongestFirst.txt");
+
+        TTK_SetOutput(output.Access());
+        TTK_SetResultCache(cache_file_name.c_str(), mode);
+        TTK_SetLongestFirst(true);
+        TTK_ADD_TEST(TestAssertSuccessA, keep_order_mode);
+        TTK_ADD_TEST(TestExpectFail, 0);
+        TTK_ADD_TEST(TestExpectSuccessB, 0);
+        TTK_ADD_TEST(TestAssertSuccessB, 0);
+        TTK_Run();
+
+        for (const TTK_TestRecord& record : TTK_GetTestRecords()) names += std::string(record.name) + " ";
+
+        TTK_Clear();
+        TTK_SetLongestFirst(false);
+        TTK_SetResultCache(nullptr, TTK_CACHE_RUN_ALL);
+    }
+    return names;
+}
+
+void Test_TTK_LongestFirst() {
+    Notice();
+
+    const std::string cache_file_name = "log/LongestFirstCache.txt";
+    const std::string cache_content = 
+        "TTK_RESULT_CACHE 1\n"
+        "P 30 0-0 TestAssertSuccessA\n"
+        "F 10 0-0 TestExpectFail\n"
+        "P 20 0-0 TestExpectSuccessB\n";
+
+    // TestAssertSuccessB has no cached duration
+    assert(SaveToFile_UTF8(cache_file_name, cache_content));
+    assert(RunLongestFirst(cache_file_name, TTK_CACHE_RUN_ALL, 0)                   == "TestAssertSuccessB TestAssertSuccessA TestExpectSuccessB TestExpectFail ");
+
+    assert(SaveToFile_UTF8(cache_file_name, cache_content));
+    assert(RunLongestFirst(cache_file_name, TTK_CACHE_FAILED_FIRST, 0)              == "TestExpectFail TestAssertSuccessB TestAssertSuccessA TestExpectSuccessB ");
+
+    assert(SaveToFile_UTF8(cache_file_name, cache_content));
+    assert(RunLongestFirst(cache_file_name, TTK_CACHE_FAILED_FIRST, TTK_KEEP_ORDER) == "TestAssertSuccessA TestExpectFail TestAssertSuccessB TestExpectSuccessB ");
+
+    // without result cache, order of adding is kept
+    assert(RunLongestFirst("", TTK_CACHE_RUN_ALL, 0)                                == "TestAssertSuccessA TestExpectFail TestExpectSuccessB TestAssertSuccessB ");
+}
+
+std::atomic<int> g_fixture_constructions[2];
+std::atomic<int> g_fixture_destructions[2];
+
+template <int INDEX>
+struct CountedFixture {
+    CountedFixture() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // other workers wait for construction
+        value = 42;
+        g_fixture_constructions[INDEX] += 1;
+    }
+
+    ~CountedFixture() {
+        g_fixture_destructions[INDEX] += 1;
+    }
+
+    int value;
+};
+
+TTK_FIXTURE(ToSharedFixture, CountedFixture<0>, TTK_FIXTURE_PER_RUN);
+TTK_FIXTURE(ToWorkerFixture, CountedFixture<1>, TTK_FIXTURE_PER_WORKER);
+
+void TestUseFixtures() {
+    TTK_ASSERT(ToSharedFixture().value == 42);
+
+    ToWorkerFixture().value += 1; // only this worker modifies it
+    TTK_ASSERT(ToWorkerFixture().value > 42);
+}
+
+void Test_TTK_Fixtures() {
+    Notice();
+
+    for (int index = 0; index < 2; ++index) {
+        g_fixture_constructions[index] = 0;
+        g_fixture_destructions[index] = 0;
+    }
+
+    for (const uint32_t number_of_workers : {1, 4}) {
+        const int prev_number_of_constructions = g_fixture_constructions[1];
+        {
+            Output output = Output("log/Out_Fixtures.txt");
+
+            TTK_SetOutput(output.Access());
+            TTK_SetNumberOfWorkers(number_of_workers);
+            for (int index = 0; index < 16; ++index) TTK_ADD_TEST(TestUseFixtures, 0);
+            assert(TTK_Run());
+            TTK_Clear();
+            TTK_SetNumberOfWorkers(1);
+        }
+
+        // destroyed at the end of each run
+        assert(g_fixture_destructions[0] == g_fixture_constructions[0]);
+        assert(g_fixture_destructions[1] == g_fixture_constructions[1]);
+
+        const int number_of_constructions = g_fixture_constructions[1] - prev_number_of_constructions;
+        assert(number_of_constructions >= 1 && number_of_constructions <= int(number_of_workers));
+    }
+
+    // once per run
+    assert(g_fixture_constructions[0] == 2);
+}
+
+enum class CompareColor : uint8_t { RED = 1, GREEN = 2 };
+
+struct ComparePoint {
+    bool operator==(const ComparePoint& other) const { return x == other.x && y == other.y; }
+
+    int32_t x;
+    int32_t y;
+};
+
+int g_compare_evaluation_counter = 0;
+
+int NextCompareValue() {
+    return ++g_compare_evaluation_counter;
+}
+
+void TestCompareSuccess() {
+    const std::string text = "abc";
+
+    TTK_ASSERT_EQ(NextCompareValue(), 1); // operand is evaluated once
+    TTK_ASSERT_NE(text, "abd");
+    TTK_ASSERT_LT(1.5, 2.5);
+    TTK_ASSERT_LE(2u, 2u);
+    TTK_ASSERT_GT('b', 'a');
+    TTK_ASSERT_GE(CompareColor::GREEN, CompareColor::RED);
+
+    TTK_EXPECT_EQ(text, std::string("abc"));
+    TTK_EXPECT_NE(&text, nullptr);
+    TTK_EXPECT_LT(-1, 0);
+    TTK_EXPECT_LE(-1, -1);
+    TTK_EXPECT_GT(3ull, 2ull);
+    TTK_EXPECT_GE(true, false);
+
+    g_test_finish_counter += 1;
+}
+
+static const uint64_t s_compare_fail_line = __LINE__ + 6;
+void TestCompareExpectFail() {
+    const std::string   text    = "line\n\"quoted\"";
+    const char*         c_text  = nullptr;
+    const ComparePoint  point   = {1, -1};
+
+    TTK_EXPECT_EQ(NextCompareValue(), 3);
+    TTK_EXPECT_NE(-7, -7);
+    TTK_EXPECT_LT(0.1 + 0.2, 0.3);
+    TTK_EXPECT_LE(2.5f, 1.0f);
+    TTK_EXPECT_GT('a', 'b');
+    TTK_EXPECT_GE(CompareColor::RED, CompareColor::GREEN);
+    TTK_EXPECT_EQ(text, "line");
+    TTK_EXPECT_EQ(c_text, "text");
+    TTK_EXPECT_EQ(true, 1 > 2);
+    TTK_EXPECT_EQ(point, (ComparePoint{1, 2}));
+    TTK_EXPECT_EQ(UINT64_MAX, 0u);
+
+    g_test_finish_counter += 1;
+}
+
+static const uint64_t s_compare_assert_fail_line = __LINE__ + 3;
+void TestCompareAssertFail() {
+    const std::string long_text(200, 'x');
+    TTK_ASSERT_EQ(long_text, "x");
+
+    g_test_finish_counter += 1;
+}
+
+void Test_TTK_CompareAsserts() {
+    Notice();
+
+    g_test_finish_counter = 0;
+    g_compare_evaluation_counter = 0;
+    const std::string output_file_name = "log/Out_CompareAsserts.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_ADD_TEST(TestCompareSuccess, 0);
+        TTK_ADD_TEST(TestCompareExpectFail, 0);
+        TTK_ADD_TEST(TestCompareAssertFail, 0);
+        assert(!TTK_Run());
+        TTK_Clear();
+    }
+    assert(g_test_finish_counter == 2);
+    assert(g_compare_evaluation_counter == 2);
+
+    const std::string fail_prefix = "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:";
+    const uint64_t line = s_compare_fail_line;
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestCompareSuccess\n"
+        "[test] TestCompareExpectFail\n" +
+        fail_prefix + std::to_string(line)      + "] [condition:NextCompareValue() == 3] [message:left: 2, right: 3]\n" +
+        fail_prefix + std::to_string(line + 1)  + "] [condition:-7 != -7] [message:left: -7, right: -7]\n" +
+        fail_prefix + std::to_string(line + 2)  + "] [condition:0.1 + 0.2 < 0.3] [message:left: 0.30000000000000004, right: 0.29999999999999999]\n" +
+        fail_prefix + std::to_string(line + 3)  + "] [condition:2.5f <= 1.0f] [message:left: 2.5, right: 1]\n" +
+        fail_prefix + std::to_string(line + 4)  + "] [condition:'a' > 'b'] [message:left: 'a', right: 'b']\n" +
+        fail_prefix + std::to_string(line + 5)  + "] [condition:CompareColor::RED >= CompareColor::GREEN] [message:left: 1, right: 2]\n" +
+        fail_prefix + std::to_string(line + 6)  + "] [condition:text == \"line\"] [message:left: \"line\\n\\\"quoted\\\"\", right: \"line\"]\n" +
+        fail_prefix + std::to_string(line + 7)  + "] [condition:c_text == \"text\"] [message:left: nullptr, right: \"text\"]\n" +
+        fail_prefix + std::to_string(line + 8)  + "] [condition:true == 1 > 2] [message:left: true, right: false]\n" +
+        fail_prefix + std::to_string(line + 9)  + "] [condition:point == (ComparePoint{1, 2})] [message:left: 8-byte object <01 00 00 00 FF FF FF FF>, right: 8-byte object <01 00 00 00 02 00 00 00>]\n" +
+        fail_prefix + std::to_string(line + 10) + "] [condition:UINT64_MAX == 0u] [message:left: 18446744073709551615, right: 0]\n"
+        "[test] TestCompareAssertFail\n" +
+        fail_prefix + std::to_string(s_compare_assert_fail_line) + "] [condition:long_text == \"x\"] [message:left: \"" + std::string(128, 'x') + "\"..., right: \"x\"]\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 24\n"
+        "number of failed asserts        : 12\n"
+        "number of executed tests        : 3\n"
+        "number of failed tests          : 2\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+void TestBulkCompareSuccess() {
+    std::vector<uint8_t> buffer(100000);
+    for (size_t index = 0; index < buffer.size(); ++index) buffer[index] = uint8_t(index * 7);
+    const std::vector<uint8_t> copy = buffer;
+
+    const int                   values[]    = {1, 2, 3};
+    const std::vector<int>      vector      = {1, 2, 3};
+    const std::list<std::string> texts      = {"a", "b"};
+
+    TTK_ASSERT_MEM_EQ(buffer.data(), copy.data(), buffer.size());
+    TTK_ASSERT_MEM_EQ(nullptr, nullptr, 0);
+    TTK_ASSERT_RANGE_EQ(values, vector);
+    TTK_ASSERT_RANGE_EQ(texts, std::vector<std::string>({"a", "b"}));
+    TTK_EXPECT_RANGE_EQ(std::vector<double>(), std::vector<double>());
+
+    g_test_finish_counter += 1;
+}
+
+static const uint64_t s_bulk_compare_fail_line = __LINE__ + 10;
+void TestBulkCompareFail() {
+    std::vector<uint8_t> buffer(100000, 0xAA);
+    std::vector<uint8_t> copy = buffer;
+    copy[50001] = 0x01;
+    copy[50002] = 0x02;
+    copy[99999] = 0x03;
+
+    const std::vector<int> vector = {1, 2, 3, 4, 5, 6};
+
+    TTK_EXPECT_MEM_EQ(buffer.data(), copy.data(), buffer.size());
+    TTK_EXPECT_RANGE_EQ(vector, std::vector<int>({1, 2, 3, 9, 5, 7}));
+    TTK_EXPECT_RANGE_EQ(std::list<double>({1.5, 2.5}), std::vector<double>({1.5}));
+    TTK_ASSERT_RANGE_EQ(std::vector<std::string>({"a", "b"}), std::vector<std::string>({"a", "c"}));
+
+    g_test_finish_counter += 1;
+}
+
+void Test_TTK_BulkCompareAsserts() {
+    Notice();
+
+    g_test_finish_counter = 0;
+    const std::string output_file_name = "log/Out_BulkCompareAsserts.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_ADD_TEST(TestBulkCompareSuccess, 0);
+        TTK_ADD_TEST(TestBulkCompareFail, 0);
+        assert(!TTK_Run());
+        TTK_Clear();
+    }
+    assert(g_test_finish_counter == 1);
+
+    const std::string fail_prefix = "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:";
+    const uint64_t line = s_bulk_compare_fail_line;
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestBulkCompareSuccess\n"
+        "[test] TestBulkCompareFail\n" +
+        fail_prefix + std::to_string(line)      + "] [condition:memcmp(buffer.data(), copy.data(), buffer.size()) == 0] [message:size: 100000, first mismatch at: 50001, number of mismatches: 3, "
+            "left[49997..50013]: AA AA AA AA AA AA AA AA AA AA AA AA AA AA AA AA, right[49997..50013]: AA AA AA AA 01 02 AA AA AA AA AA AA AA AA AA AA]\n" +
+        fail_prefix + std::to_string(line + 1)  + "] [condition:vector == std::vector<int>({1, 2, 3, 9, 5, 7})] [message:left size: 6, right size: 6, first mismatch at: 3, number of mismatches: 2, "
+            "left[1..6]: 2, 3, 4, 5, 6, right[1..6]: 2, 3, 9, 5, 7]\n" +
+        fail_prefix + std::to_string(line + 2)  + "] [condition:std::list<double>({1.5, 2.5}) == std::vector<double>({1.5})] [message:left size: 2, right size: 1, first mismatch at: 1, number of mismatches: 1, "
+            "left[0..2]: 1.5, 2.5, right[0..1]: 1.5]\n" +
+        fail_prefix + std::to_string(line + 3)  + "] [condition:std::vector<std::string>({\"a\", \"b\"}) == std::vector<std::string>({\"a\", \"c\"})] [message:left size: 2, right size: 2, first mismatch at: 1, number of mismatches: 1, "
+            "left[0..2]: \"a\", \"b\", right[0..2]: \"a\", \"c\"]\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 9\n"
+        "number of failed asserts        : 4\n"
+        "number of executed tests        : 2\n"
+        "number of failed tests          : 1\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+void TestArrayNearSuccess() {
+    std::vector<float>  actual(1001);
+    std::vector<float>  expected(1001);
+    for (size_t index = 0; index < expected.size(); ++index) {
+        expected[index] = float(index) * 0.25f - 100.0f;
+        actual[index]   = std::nextafter(expected[index], 1000.0f);
+    }
+    expected[7] = actual[7] = std::numeric_limits<float>::quiet_NaN();
+    expected[8] = actual[8] = -std::numeric_limits<float>::infinity();
+
+    const double actual_values[]    = {1.0, 1e10, 0.0, 2e-20};
+    const double expected_values[]  = {1.0 + 1e-12, 1e10 + 1.0, -0.0, 1e-20};
+
+    // distance between numbers of different signs passes through zero
+    const double signed_actual_values[]     = {-0.0, std::numeric_limits<double>::denorm_min()};
+    const double signed_expected_values[]   = {std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::denorm_min()};
+
+    // expected[400] is zero, so its error is absolute error divided by min magnitude
+    TTK_ASSERT_ARRAY_NEAR(actual.data(), expected.data(), expected.size(), 1e-6, 1e-30);
+    TTK_ASSERT_ARRAY_NEAR_ULP(actual.data(), expected.data(), expected.size(), 1);
+    TTK_ASSERT_ARRAY_NEAR(actual_values, expected_values, 4, 1e-9, 1e-10);
+    TTK_EXPECT_ARRAY_NEAR_ULP(actual_values, actual_values, 4, 0);
+    TTK_ASSERT_ARRAY_NEAR_ULP(signed_actual_values, signed_expected_values, 2, 2);
+
+    g_test_finish_counter += 1;
+}
+
+static const uint64_t s_array_near_fail_line = __LINE__ + 16;
+void TestArrayNearFail() {
+    std::vector<float> actual(1000, 1.0f);
+    std::vector<float> expected(1000, 1.0f);
+    actual[10]  = 1.5f;
+    actual[20]  = 0.75f;
+    actual[30]  = std::numeric_limits<float>::quiet_NaN();
+    actual[999] = std::nextafter(1.0f, 2.0f);
+
+    const double actual_values[]    = {1.0, 2.0, -std::numeric_limits<double>::infinity()};
+    const double expected_values[]  = {1.0, std::nextafter(2.0, 3.0), std::numeric_limits<double>::infinity()};
+
+    // error is relative also for numbers of small magnitude
+    const float small_actual_values[]   = {2e-9f, 0.0f};
+    const float small_expected_values[] = {1e-9f, 0.0f};
+
+    TTK_EXPECT_ARRAY_NEAR(actual.data(), expected.data(), expected.size(), 0.1, 0);
+    TTK_EXPECT_ARRAY_NEAR_ULP(actual_values, expected_values, 2, 0);
+    TTK_EXPECT_ARRAY_NEAR(small_actual_values, small_expected_values, 2, 1e-6, 1e-30);
+    TTK_ASSERT_ARRAY_NEAR(actual_values, expected_values, 3, 1e-3, 0);
+
+    g_test_finish_counter += 1;
+}
+
+void Test_TTK_ArrayNearAsserts() {
+    Notice();
+
+    g_test_finish_counter = 0;
+    const std::string output_file_name = "log/Out_ArrayNearAsserts.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_ADD_TEST(TestArrayNearSuccess, 0);
+        TTK_ADD_TEST(TestArrayNearFail, 0);
+        assert(!TTK_Run());
+        TTK_Clear();
+    }
+    assert(g_test_finish_counter == 1);
+
+    const std::string fail_prefix = "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:";
+    const uint64_t line = s_array_near_fail_line;
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] TestArrayNearSuccess\n"
+        "[test] TestArrayNearFail\n" +
+        fail_prefix + std::to_string(line)      + "] [condition:relative error of actual.data() and expected.data() <= 0.1] [message:size: 1000, number of exceeded: 3, number of infinite errors: 1, "
+            "max error: inf at: 30 (actual: nan, expected: 1), mean error: 0.000750751]\n" +
+        fail_prefix + std::to_string(line + 1)  + "] [condition:ulp distance of actual_values and expected_values <= 0] [message:size: 2, number of exceeded: 1, number of infinite errors: 0, "
+            "max error: 1 at: 1 (actual: 2, expected: 2.0000000000000004), mean error: 0.5]\n" +
+        fail_prefix + std::to_string(line + 2)  + "] [condition:relative error of small_actual_values and small_expected_values <= 1e-6] [message:size: 2, number of exceeded: 1, number of infinite errors: 0, "
+            "max error: 1 at: 0 (actual: 1.99999994e-09, expected: 9.99999972e-10), mean error: 0.5]\n" +
+        fail_prefix + std::to_string(line + 3)  + "] [condition:relative error of actual_values and expected_values <= 1e-3] [message:size: 3, number of exceeded: 1, number of infinite errors: 1, "
+            "max error: inf at: 2 (actual: -inf, expected: inf), mean error: 1.11022e-16]\n"
+        "--- TEST FAIL ---\n"
+        "number of executed asserts      : 9\n"
+        "number of failed asserts        : 4\n"
+        "number of executed tests        : 2\n"
+        "number of failed tests          : 1\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
+TTK_TAGGED_TEST(TestTaggedSmoke_InPlace, TTK_DISABLE, "smoke") {}
+
+// Runs tagged test functions with filter by tags. Returns names of executed test functions.
+std::string RunTagged(const char* expression) {
+    std::string names;
+    {
+        Output output = Output("log/Out_Tags.txt");
+
+        TTK_SetOutput(output.Access());
+        assert(TTK_SetTagFilter(expression));
+        TTK_ADD_TAGGED_TEST(TestAssertSuccessA, 0, "smoke");
+        TTK_ADD_TAGGED_TEST(TestAssertSuccessB, 0, "slow io");
+        TTK_ADD_TAGGED_TEST(TestExpectSuccessA, 0, "smoke, slow");
+        TTK_ADD_TAGGED_TEST(TestExpectSuccessB, 0, "gpu-free,io");
+        TTK_ADD_TEST(TestExpectFail, 0);
+        TTK_Run();
+
+        for (const TTK_TestRecord& record : TTK_GetTestRecords()) names += std::string(record.name) + " ";
+
+        TTK_Clear();
+        assert(TTK_SetTagFilter(nullptr));
+    }
+    return names;
+}
+
+void Test_TTK_Tags() {
+    Notice();
+
+    assert(RunTagged(nullptr)                           == "TestAssertSuccessA TestAssertSuccessB TestExpectSuccessA TestExpectSuccessB TestExpectFail ");
+    assert(RunTagged("smoke")                           == "TestAssertSuccessA TestExpectSuccessA ");
+    assert(RunTagged("smoke and not slow")              == "TestAssertSuccessA ");
+    assert(RunTagged("smoke & !slow")                   == "TestAssertSuccessA ");
+    assert(RunTagged("not smoke")                       == "TestAssertSuccessB TestExpectSuccessB TestExpectFail ");
+    assert(RunTagged("io or smoke and slow")            == "TestAssertSuccessB TestExpectSuccessA TestExpectSuccessB ");
+    assert(RunTagged("(io | smoke) & slow")             == "TestAssertSuccessB TestExpectSuccessA ");
+    assert(RunTagged("gpu-free")                        == "TestExpectSuccessB ");
+    assert(RunTagged("order")                           == "");     // unknown tag, not operator 'or'
+    assert(RunTagged("!!smoke")                         == "TestAssertSuccessA TestExpectSuccessA ");
+
+    for (const char* expression : {"smoke and", "(smoke", "smoke)", "smoke slow", "& smoke", "!", "smoke | | slow", "smoke $"}) {
+        assert(!TTK_SetTagFilter(expression));
+    }
+
+    // selection over many test functions, with bits in several words
+    {
+        Output output = Output("log/Out_Tags.txt");
+
+        static const char* const s_tags[] = {"a", "b", "a b", ""};
+
+        TTK_SetOutput(output.Access());
+        assert(TTK_SetTagFilter("a and not b"));
+        TTK_ReserveTests(1000);
+        for (int index = 0; index < 1000; ++index) TTK_ADD_TAGGED_TEST(EmptyTest, 0, s_tags[index % 4]);
+
+        g_test_finish_counter = 0;
+        assert(TTK_Run());
+        assert(g_test_finish_counter == 250);
+
+        TTK_Clear();
+        assert(TTK_SetTagFilter(nullptr));
+    }
+}
+
 
 TTK_TEST(TestAssertSuccessA_InPlace, 0) {
     TTK_ASSERT(1 == 1);
@@ -1150,6 +2872,9 @@ TTK_TEST(TestExpectFail_InPlace, 0) {
 void Test_TTK_RunFail_InPlace() {
     Notice();
 
+    // Test functions from StaticRegistration.cpp are collected at first TTK_Run, and precede the ones added before main.
+    const bool is_static = IsStaticRegistrationAvailable();
+
     g_test_finish_counter = 0;
     const std::string output_file_name = "log/Out_RunFail_InPlace.txt";
     {
@@ -1159,11 +2884,14 @@ void Test_TTK_RunFail_InPlace() {
         TTK_Run();
         TTK_Clear();
     }
-    assert(g_test_finish_counter == 4);
+    assert(g_test_finish_counter == (is_static ? 7 : 4));
 
     const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
     const std::string expected_output_contnet = 
-        "--- TEST ---\n"
+        "--- TEST ---\n" + std::string(is_static ? 
+        "[test] TestStaticB_InPlace\n"
+        "[test] TestStaticA_InPlace\n"
+        "[test] TestStaticC_InPlace\n" : "") +
         "[test] TestAssertSuccessA_InPlace\n"
         "[test] TestAssertFail_InPlace\n"
         "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[0]) + "] [condition:200 > 200] [message:Message 1.]\n"
@@ -1173,14 +2901,43 @@ void Test_TTK_RunFail_InPlace() {
         "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[10]) + "] [condition:200 > 200] [message:Message 1.]\n"
         "    [fail] [file:" + GetSourceFileName_UTF8() + "] [line:" + std::to_string(g_line[11]) + "] [condition:300 > 300] [message:Message 2.]\n"
         "--- TEST FAIL ---\n"
-        "number of executed asserts      : 18\n"
+        "number of executed asserts      : " + std::to_string(is_static ? 21 : 18) + "\n"
         "number of failed asserts        : 3\n"
-        "number of executed tests        : 5\n"
+        "number of executed tests        : " + std::to_string(is_static ? 8 : 5) + "\n"
         "number of failed tests          : 2\n";
     PrintIfMissmatch(output_contnet, expected_output_contnet);
     assert(output_contnet == expected_output_contnet);
 }
 
+void Test_TTK_StaticTestsCleared_InPlace() {
+    Notice();
+
+    // Records from linker section are removed by TTK_Clear, so they aren't collected again.
+    g_test_finish_counter = 0;
+    const std::string output_file_name = "log/Out_StaticTestsCleared_InPlace.txt";
+    {
+        Output output = Output(output_file_name);
+
+        TTK_SetOutput(output.Access());
+        TTK_ADD_TEST(EmptyTest, 0);
+        TTK_Run();
+        TTK_Clear();
+    }
+    assert(g_test_finish_counter == 1);
+
+    const std::string output_contnet = LoadFromFile_UTF8(output_file_name);
+    const std::string expected_output_contnet = 
+        "--- TEST ---\n"
+        "[test] EmptyTest\n"
+        "--- TEST SUCCESS ---\n"
+        "number of executed asserts      : 0\n"
+        "number of failed asserts        : 0\n"
+        "number of executed tests        : 1\n"
+        "number of failed tests          : 0\n";
+    PrintIfMissmatch(output_contnet, expected_output_contnet);
+    assert(output_contnet == expected_output_contnet);
+}
+
 class FlagRegister {
 public:
     FlagRegister() {}
@@ -1207,10 +2964,9 @@ void RunAllTests(int argc, char* argv[]) {
 
     if (IsFlag("WIDE")) SwitchStdOutToWideOriented();
 
-    if (IsStdOutWideOriented()) {
-        _wsystem(L"if exist log @rd /S /Q log");
-        _wsystem(L"mkdir log");
+    RecreateFolder("log");
 
+    if (IsStdOutWideOriented()) {
         wprintf(L"%hs\n", "--- Wide Oriented ---");
         wprintf(L"sizeof(void*)=%d\n", (int)sizeof(void*));
 
@@ -1218,9 +2974,6 @@ void RunAllTests(int argc, char* argv[]) {
 
         TTK_ForceOutputOrientation(1);
     } else {
-        system("if exist log @rd /S /Q log");
-        system("mkdir log");
-
         puts("--- Narrow Oriented  ---");
         printf("sizeof(void*)=%d\n", (int)sizeof(void*));
 
@@ -1236,6 +2989,7 @@ void RunAllTests(int argc, char* argv[]) {
 
     if (IsFlag("IN_PLACE")) {
         Test_TTK_RunFail_InPlace();
+        Test_TTK_StaticTestsCleared_InPlace();
     } else {
         TTK_Clear();
 
@@ -1266,8 +3020,43 @@ void RunAllTests(int argc, char* argv[]) {
         Test_TTK_RunFailNoAbort();
         Test_TTK_RunFailNoAbort2();
         Test_TTK_RunSuccessDisable();
+        Test_TTK_RunOnWorkers();
+        Test_TTK_RunOnWorkersFail();
+        Test_TTK_RunInChildProcesses();
+#ifdef TTK_PROCESS_ISOLATION_AVAILABLE
+        Test_TTK_RunInChildProcessesCrash();
+        Test_TTK_RunInChildProcessesAsyncOutput();
+        Test_TTK_RunInChildProcessesTimeout();
+        Test_TTK_RunWatchdog();
+        Test_TTK_RunWatchdogFailing();
+        Test_TTK_OutputModeCrash();
+#endif
+        Test_TTK_RunShard();
+        Test_TTK_TestRecords();
+        Test_TTK_Benchmark();
+        Test_TTK_OutputMode();
+        Test_TTK_DecodeUTF8();
+        Test_TTK_Reporters();
+        Test_TTK_MatchGlob();
+        Test_TTK_RunFilter();
+        Test_TTK_Register();
+        Test_TTK_ParameterizedTests();
+        Test_TTK_Property();
+        Test_TTK_Allocations();
+        Test_TTK_Baselines();
+        Test_TTK_ResultCache();
+        Test_TTK_MaxFailures();
+        Test_TTK_LongestFirst();
+        Test_TTK_Fixtures();
+        Test_TTK_CompareAsserts();
+        Test_TTK_BulkCompareAsserts();
+        Test_TTK_ArrayNearAsserts();
+        Test_TTK_Tags();
     }
 
+    // Output files of tests are already closed, and output of suite is closed at exit.
+    TTK_SetOutput(stdout);
+
     if (IsStdOutWideOriented()) {
         wprintf(L"%hs\n", "--- Test End ---");
     } else {
@@ -5,4 +5,7 @@ enum { MAX_REG_LINES = 100 };
 
 void RunAllTests(int argc, char* argv[]);
 
+// Returns true, when test functions from StaticRegistration.cpp are placed in linker section (see TTK_STATIC_REGISTRATION).
+bool IsStaticRegistrationAvailable();
+
 #endif // TESTS_H_
\ No newline at end of file
@@ -35,15 +35,55 @@
 
 #include <stdio.h>
 #include <stdint.h>
-#include <locale.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <errno.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Bulk comparisons of memory use SSE2, when it's available on target.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TTK_SSE2_AVAILABLE
+#endif
+
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #undef WIN32_LEAN_AND_MEAN
+#else
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// Test functions can be executed in child processes (see TTK_SetProcessIsolation).
+#define TTK_PROCESS_ISOLATION_AVAILABLE
+#endif
 
 #include <string>
 #include <vector>
 #include <utility>
+#include <memory>
+#include <iterator>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <regex>
+#include <tuple>
+#include <limits>
+#include <type_traits>
+#include <new>
 
 // Checks the condition. If the condition failed (is false), then information about fail is displayed.
 // Further execution of current test function is aborted. Further execution of remaining test functions is aborted.
@@ -51,8 +91,8 @@
 //                      Must resolve to bool type value.
 // message              (Optional) An addition message, to be displayed when condition fails. 
 //                      Type can by either an c-string or std::string. Encoding can be either ASCII or UTF8.
-#define TTK_ASSERT(condition)               { TTK_ToSuite().IncNumOfAssertExecutions(); if (!(condition)) { TTK_ToSuite().CommunicateAssertFail(__LINE__, #condition, TTK_L(__FILE__), TTK_U8(__FILE__), nullptr); TTK_ToSuite().RequestAbort(); return; } } (void)0
-#define TTK_ASSERT_M(condition, message)    { TTK_ToSuite().IncNumOfAssertExecutions(); if (!(condition)) { TTK_ToSuite().CommunicateAssertFail(__LINE__, #condition, TTK_L(__FILE__), TTK_U8(__FILE__), message); TTK_ToSuite().RequestAbort(); return; } } (void)0
+#define TTK_ASSERT(condition)               { TTK_ToNumberOfExecutedAsserts() += 1; if (TTK_UNLIKELY(!(condition))) { TTK_AssertFail(__LINE__, #condition, TTK_U8(__FILE__), nullptr); return; } } (void)0
+#define TTK_ASSERT_M(condition, message)    { TTK_ToNumberOfExecutedAsserts() += 1; if (TTK_UNLIKELY(!(condition))) { TTK_AssertFail(__LINE__, #condition, TTK_U8(__FILE__), message); return; } } (void)0
 
 // Checks the condition. If the condition failed (is false), then information about fail is displayed. 
 // Further execution of current test and remaining tests is continued (no test abort).
@@ -60,36 +100,246 @@
 //                      Must resolve to bool type value.
 // message              (Optional) An addition message, to be displayed when condition fails. 
 //                      Type can by either an c-string or std::string. Encoding can be either ASCII or UTF8.
-#define TTK_EXPECT(condition)               { TTK_ToSuite().IncNumOfAssertExecutions(); if (!(condition)) { TTK_ToSuite().CommunicateAssertFail(__LINE__, #condition, TTK_L(__FILE__), TTK_U8(__FILE__), nullptr); } } (void)0
-#define TTK_EXPECT_M(condition, message)    { TTK_ToSuite().IncNumOfAssertExecutions(); if (!(condition)) { TTK_ToSuite().CommunicateAssertFail(__LINE__, #condition, TTK_L(__FILE__), TTK_U8(__FILE__), message); } } (void)0
+#define TTK_EXPECT(condition)               { TTK_ToNumberOfExecutedAsserts() += 1; if (TTK_UNLIKELY(!(condition))) { TTK_ExpectFail(__LINE__, #condition, TTK_U8(__FILE__), nullptr); } } (void)0
+#define TTK_EXPECT_M(condition, message)    { TTK_ToNumberOfExecutedAsserts() += 1; if (TTK_UNLIKELY(!(condition))) { TTK_ExpectFail(__LINE__, #condition, TTK_U8(__FILE__), message); } } (void)0
+
+// Checks comparison of two values. If the comparison failed, then information about fail is displayed, with both values.
+// Further execution of current test function and remaining test functions is aborted (as by TTK_ASSERT).
+// Each operand is evaluated exactly once and is captured by reference. Values are formatted only when the comparison fails, 
+// into fixed buffer on stack (no allocation, no streams). Formatted are: bool, characters, integers, enums, floating point numbers, 
+// c-strings, character arrays, std::string, pointers and nullptr. Other types are displayed as bytes of value (at most 16).
+// Formatting of own type can be provided by overload: void TTK_FormatValue(TTK_TextBuffer& buffer, const Type& value) (found by argument-dependent lookup).
+// left                 Left operand of comparison.
+// right                Right operand of comparison.
+// Example:             TTK_ASSERT_EQ(Sum(2, 3), 5);
+#define TTK_ASSERT_EQ(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, ==, #left " == " #right, true, return;)
+#define TTK_ASSERT_NE(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, !=, #left " != " #right, true, return;)
+#define TTK_ASSERT_LT(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, <, #left " < " #right, true, return;)
+#define TTK_ASSERT_LE(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, <=, #left " <= " #right, true, return;)
+#define TTK_ASSERT_GT(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, >, #left " > " #right, true, return;)
+#define TTK_ASSERT_GE(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, >=, #left " >= " #right, true, return;)
+
+// Checks comparison of two values (see TTK_ASSERT_EQ). 
+// Further execution of current test and remaining tests is continued (no test abort, as by TTK_EXPECT).
+#define TTK_EXPECT_EQ(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, ==, #left " == " #right, false, )
+#define TTK_EXPECT_NE(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, !=, #left " != " #right, false, )
+#define TTK_EXPECT_LT(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, <, #left " < " #right, false, )
+#define TTK_EXPECT_LE(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, <=, #left " <= " #right, false, )
+#define TTK_EXPECT_GT(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, >, #left " > " #right, false, )
+#define TTK_EXPECT_GE(left, right)  TTK_INNER_ASSERT_COMPARE(left, right, >=, #left " >= " #right, false, )
+
+// Checks that two blocks of memory are equal. Counts as single assertion.
+// If check fails, then information about fail is displayed: first mismatched byte, number of mismatched bytes and hex bytes around first mismatch.
+// Further execution of current test function and remaining test functions is aborted (as by TTK_ASSERT).
+// left                 Pointer to first block of memory.
+// right                Pointer to second block of memory.
+// size                 Size of each block in bytes.
+// Example:             TTK_ASSERT_MEM_EQ(output.data(), expected.data(), expected.size());
+#define TTK_ASSERT_MEM_EQ(left, right, size)    TTK_INNER_ASSERT_MEM_EQ(left, right, size, "memcmp(" #left ", " #right ", " #size ") == 0", true, return;)
+
+// Checks that two ranges have the same size and equal elements (compared by operator==). Counts as single assertion.
+// Contiguous ranges (arrays and containers with data() and size()) of integers, enums or pointers are compared as memory.
+// If check fails, then information about fail is displayed: sizes, first mismatched element, number of mismatched elements and elements around first mismatch.
+// Further execution of current test function and remaining test functions is aborted (as by TTK_ASSERT).
+// left                 First range (array or container).
+// right                Second range (array or container).
+// Example:             TTK_ASSERT_RANGE_EQ(values, std::vector<int>({1, 2, 3}));
+#define TTK_ASSERT_RANGE_EQ(left, right)        TTK_INNER_ASSERT_RANGE_EQ(left, right, #left " == " #right, true, return;)
+
+// Checks that two blocks of memory or two ranges are equal (see TTK_ASSERT_MEM_EQ and TTK_ASSERT_RANGE_EQ). 
+// Further execution of current test and remaining tests is continued (no test abort, as by TTK_EXPECT).
+#define TTK_EXPECT_MEM_EQ(left, right, size)    TTK_INNER_ASSERT_MEM_EQ(left, right, size, "memcmp(" #left ", " #right ", " #size ") == 0", false, )
+#define TTK_EXPECT_RANGE_EQ(left, right)        TTK_INNER_ASSERT_RANGE_EQ(left, right, #left " == " #right, false, )
+
+// Checks that two arrays of floating point numbers (float or double) are equal within relative tolerance. Counts as single assertion.
+// Error of element is: |actual - expected| / max(min_magnitude, |expected|), so it's relative, 
+// except for expected numbers with magnitude below min_magnitude, which error is absolute error divided by min_magnitude.
+// NaN is equal only to NaN, and infinity is equal only to infinity of the same sign. Otherwise error of element with NaN or infinity is infinite.
+// Errors are computed with SSE2, when it's available.
+// If check fails, then single information about fail is displayed: worst element, maximal and mean error (of finite errors), 
+// number of elements exceeding tolerance and number of elements with infinite error.
+// Further execution of current test function and remaining test functions is aborted (as by TTK_ASSERT).
+// actual               Pointer to array of computed numbers.
+// expected             Pointer to array of reference numbers, of the same type.
+// size                 Number of elements of each array.
+// tolerance            Maximal error of element. For example: 1e-5.
+// min_magnitude        Floor of magnitude of expected numbers, for numbers near zero. For example: 1e-30. 
+//                      0 - error is always relative, so any error of element with expected zero is infinite.
+// Example:             TTK_ASSERT_ARRAY_NEAR(output.data(), reference.data(), reference.size(), 1e-5, 1e-30);
+#define TTK_ASSERT_ARRAY_NEAR(actual, expected, size, tolerance, min_magnitude) \
+    TTK_INNER_ASSERT_ARRAY_NEAR(actual, expected, size, tolerance, min_magnitude, TTK_ARRAY_ERROR_RELATIVE, "relative error of " #actual " and " #expected " <= " #tolerance, true, return;)
+
+// Checks that two arrays of floating point numbers (float or double) are equal within distance in units in the last place (see TTK_ASSERT_ARRAY_NEAR). 
+// Error of element is number of representable numbers between actual and expected number (0 and -0 are the same number).
+// max_ulps             Maximal distance of element in units in the last place. For example: 4.
+// Example:             TTK_ASSERT_ARRAY_NEAR_ULP(output.data(), reference.data(), reference.size(), 4);
+#define TTK_ASSERT_ARRAY_NEAR_ULP(actual, expected, size, max_ulps)  TTK_INNER_ASSERT_ARRAY_NEAR(actual, expected, size, max_ulps, 0, TTK_ARRAY_ERROR_ULP, "ulp distance of " #actual " and " #expected " <= " #max_ulps, true, return;)
+
+// Checks that two arrays of floating point numbers are equal within tolerance (see TTK_ASSERT_ARRAY_NEAR and TTK_ASSERT_ARRAY_NEAR_ULP). 
+// Further execution of current test and remaining tests is continued (no test abort, as by TTK_EXPECT).
+#define TTK_EXPECT_ARRAY_NEAR(actual, expected, size, tolerance, min_magnitude) \
+    TTK_INNER_ASSERT_ARRAY_NEAR(actual, expected, size, tolerance, min_magnitude, TTK_ARRAY_ERROR_RELATIVE, "relative error of " #actual " and " #expected " <= " #tolerance, false, )
+#define TTK_EXPECT_ARRAY_NEAR_ULP(actual, expected, size, max_ulps)  TTK_INNER_ASSERT_ARRAY_NEAR(actual, expected, size, max_ulps, 0, TTK_ARRAY_ERROR_ULP, "ulp distance of " #actual " and " #expected " <= " #max_ulps, false, )
+
+// Checks that code in block following this macro allocates memory at most max_number_of_allocations times. Block is executed once.
+// Allocations are counted on current thread by allocation hooks, which must be defined in program (see TTK_ALLOCATION_HOOKS). 
+// If allocation hooks are not defined, then check always fails.
+// If check fails, then information about fail is displayed (with number of allocations and allocated bytes). 
+// Further execution of current test function and remaining test functions is aborted (as by TTK_ASSERT).
+// Example:             TTK_ASSERT_MAX_ALLOCS(1) { values.push_back(value); }
+#define TTK_ASSERT_MAX_ALLOCS(max_number_of_allocations) TTK_INNER_ASSERT_ALLOCS(TTK_CONCAT(ttk_allocation_scope_, __LINE__), max_number_of_allocations, "number of allocations <= " #max_number_of_allocations)
+
+// Checks that code in block following this macro doesn't allocate memory (see TTK_ASSERT_MAX_ALLOCS).
+// Example:             TTK_ASSERT_NO_ALLOC { values[0] = value; }
+#define TTK_ASSERT_NO_ALLOC TTK_INNER_ASSERT_ALLOCS(TTK_CONCAT(ttk_allocation_scope_, __LINE__), 0, "number of allocations == 0")
+
+// Checks that code in block following this macro isn't slower than its baseline time, stored under key in baseline file (see TTK_SetBaseline). 
+// Block is executed repeatedly and its median time per execution is measured as of benchmark function (see TTK_SetBenchmarkConfig). 
+// Block shouldn't be left by break. 
+// If there is no baseline for key, then measured time is recorded as baseline or only displayed, depending on mode of baselines.
+// If check fails, then information about fail is displayed (with measured and baseline time). 
+// Further execution of current test function and remaining test functions is aborted (as by TTK_ASSERT).
+// key                  Name of baseline (utf-8 string without new line character). Should be unique in program.
+// tolerance            How much slower block can be than baseline. For example: 0.1 - at most 10% slower.
+// Example:             TTK_ASSERT_NOT_SLOWER("sort 1000 ints", 0.1) { std::sort(values.begin(), values.end()); }
+#define TTK_ASSERT_NOT_SLOWER(key, tolerance) TTK_INNER_ASSERT_NOT_SLOWER(TTK_CONCAT(ttk_timing_scope_, __LINE__), key, tolerance, "time <= baseline * (1 + " #tolerance ")")
+
+// Allocation hooks. When TTK_ALLOCATION_HOOKS is defined before including this header in exactly one translation unit of program (for example in main.cpp), 
+// then global operators new and delete are replaced, and with glibc also malloc, calloc, realloc, free, memalign, aligned_alloc and posix_memalign. 
+// They count allocations, allocated bytes and peak of allocated bytes of each test function (see TTK_GetTestRecords and TTK_SetAllocationReport). 
+// Only allocations made on thread which executes test function are counted for it.
 
 enum : uint64_t {
     TTK_DEFAULT     =   0x0000,
     TTK_DISABLE     =   0x0001,     // disable test
     TTK_NO_ABORT    =   0x0002,     // no abort or remaining test functions at assertion fail, still aborts current test function
+    TTK_KEEP_ORDER  =   0x0004,     // test function keeps its place in order of adding, when test functions are reordered (see TTK_SetLongestFirst)
 };
 
+// Timeout of test function, in milliseconds (up to 2^32 - 1), placed in mode together with other flags (for example: TTK_NO_ABORT | TTK_TIMEOUT_MS(500)).
+// Overrides default timeout of test functions set by TTK_SetTimeout.
+#define TTK_TIMEOUT_MS(milliseconds) (uint64_t(uint32_t(milliseconds)) << 32)
+
 // Adds test functions to be executed.
-// Tests added this way will be executed in order of adding.
+// Tests added this way will be executed in order of adding (unless they are reordered, see TTK_SetLongestFirst and TTK_SetResultCache).
 // TestFunction         Existing test function of type: void (*)().
 // mode                 Bitfield made from any combination of flags: 
 //                          0, TTK_DEFAULT      - no changes to default behavior, 
 //                          TTK_DISABLE         - this test function will be skipped, 
-//                          TTK_NO_ABORT        - execution of remaining tests will be continued even if this test function fails.
-#define TTK_ADD_TEST(TestFunction, mode) TTK_ToSuite().AddTest({TestFunction, #TestFunction, mode})
+//                          TTK_NO_ABORT        - execution of remaining tests will be continued even if this test function fails, 
+//                          TTK_TIMEOUT_MS(n)   - test function fails, if it's executed longer than n milliseconds (see TTK_SetTimeout), 
+//                          TTK_KEEP_ORDER      - test function isn't moved, when test functions are reordered (see TTK_SetLongestFirst).
+#define TTK_ADD_TEST(TestFunction, mode) TTK_ToSuite().AddTest({TestFunction, #TestFunction, mode, nullptr, nullptr, 0, nullptr})
 
 // Declares test function and adds it to be executed.
-// Tests added this way will be executed in order of adding.
+// Tests added this way will be executed in order of adding (unless they are reordered, see TTK_SetLongestFirst and TTK_SetResultCache).
+// When TTK_STATIC_REGISTRATION is defined before include of this header, and TTK_STATIC_REGISTRATION_AVAILABLE gets defined 
+// (ELF targets built by GCC or Clang, and MSVC), test function is added without executing any code before main. 
+// It can be defined only for some source files. 
+// Its record is constant data placed in dedicated linker section, and records are collected at first TTK_Run. 
+// Such test functions are executed before test functions added by TTK_ADD_TEST, ordered by source file name and line. 
+// TTK_Clear removes them as well. 
 // TestFunction         Not-existing test function.
 // mode                 Bitfield made from any combination of flags: 
 //                          0, TTK_DEFAULT      - no changes to default behavior, 
 //                          TTK_DISABLE         - this test function will be skipped, 
-//                          TTK_NO_ABORT        - execution of remaining tests will be continued even if this test function fails.
+//                          TTK_NO_ABORT        - execution of remaining tests will be continued even if this test function fails, 
+//                          TTK_TIMEOUT_MS(n)   - test function fails, if it's executed longer than n milliseconds (see TTK_SetTimeout), 
+//                          TTK_KEEP_ORDER      - test function isn't moved, when test functions are reordered (see TTK_SetLongestFirst).
 #define TTK_TEST(TestFunction, mode) \
     void TestFunction(); \
-    static bool s_is_force_called_before_main_##TestFunction = (TTK_ADD_TEST(TestFunction, mode), true); \
+    TTK_INNER_REGISTER_TEST(TestFunction, TestFunction, mode, nullptr); \
+    void TestFunction()
+
+// Adds test function with tags (see TTK_ADD_TEST). Test functions can be selected by expression of tags (see TTK_SetTagFilter).
+// tags                 C-string literal with names of tags separated by spaces or commas (for example "smoke io"). 
+//                      Name of tag can contain letters, digits, '_', '-' and '.'.
+#define TTK_ADD_TAGGED_TEST(TestFunction, mode, tags) TTK_ToSuite().AddTest({TestFunction, #TestFunction, mode, nullptr, nullptr, 0, tags})
+
+// Declares test function with tags and adds it to be executed (see TTK_TEST and TTK_ADD_TAGGED_TEST).
+#define TTK_TAGGED_TEST(TestFunction, mode, tags) \
+    void TestFunction(); \
+    TTK_INNER_REGISTER_TEST(TestFunction, TestFunction, mode, tags); \
     void TestFunction()
 
+// Adds benchmark function to be executed as test function.
+// BenchmarkFunction    Existing benchmark function of type: void (*)(TTK_BenchmarkState&).
+// mode                 Same as in TTK_ADD_TEST.
+#define TTK_ADD_BENCHMARK(BenchmarkFunction, mode) TTK_ToSuite().AddTest({TTK_ExecuteBenchmark<BenchmarkFunction>, #BenchmarkFunction, mode, nullptr, nullptr, 0, nullptr})
+
+// Declares benchmark function and adds it to be executed as test function.
+// Measured code must be placed in loop: while (state.KeepRunning()) { ... }. 
+// Number of iterations is calibrated, until single sample takes at least minimal sample time (calibration runs are warmup as well). 
+// Then samples are collected, and mean, median, standard deviation and minimum of time per iteration are displayed.
+// BenchmarkFunction    Not-existing benchmark function. Its parameter 'state' is of type TTK_BenchmarkState&.
+// mode                 Same as in TTK_TEST.
+#define TTK_BENCHMARK(BenchmarkFunction, mode) \
+    void BenchmarkFunction(TTK_BenchmarkState& state); \
+    TTK_INNER_REGISTER_TEST(BenchmarkFunction, TTK_ExecuteBenchmark<BenchmarkFunction>, mode, nullptr); \
+    void BenchmarkFunction(TTK_BenchmarkState& state)
+
+// Declares property: test function which checks its body for many random values made by generator. 
+// Value is available in body as 'param' of type const Value_T& of generator (for example const int& for TTK_GenInt<int>). 
+// When any assertion in body fails, value is shrunk to the simplest value for which body still fails (counterexample). 
+// Then single assertion fail is reported with counterexample, number of case and seed, and remaining test functions are aborted (as by TTK_ASSERT). 
+// Values are reused between cases, so generating and checking of case doesn't allocate memory 
+// (except when container grows above capacity reached by previous cases).
+// TestFunction         Not-existing test function.
+// generator            Generator of values, made by: TTK_GenInt, TTK_GenReal, TTK_GenBool, TTK_GenVector, TTK_GenString or TTK_GenTuple. 
+//                      It's macro argument, so it can't contain template argument list with comma outside of parentheses.
+// mode                 Same as in TTK_TEST.
+#define TTK_PROPERTY(TestFunction, generator, mode) \
+    void TestFunction##_Property(const decltype(generator)::Value_T& param); \
+    void TestFunction() { TTK_CheckProperty(generator, TestFunction##_Property, #TestFunction); } \
+    TTK_INNER_REGISTER_TEST(TestFunction, TestFunction, mode, nullptr); \
+    void TestFunction##_Property(const decltype(generator)::Value_T& param)
+
+enum TTK_FixtureScope {
+    TTK_FIXTURE_PER_RUN,        // single object is shared by all workers
+    TTK_FIXTURE_PER_WORKER,     // each worker has own object
+};
+
+// Declares fixture: function 'Type& Name()', which returns object shared by test functions (for example loaded data set). 
+// Object is constructed by default constructor at first call of Name(), and destroyed at the end of TTK_Run 
+// (fixtures are destroyed in reverse order of construction), so next TTK_Run constructs it again when it's needed.
+// With process isolation (see TTK_SetProcessIsolation), object constructed in child process is destroyed with it, 
+// but object constructed before TTK_Run (for example by calling Name() in main) is inherited by all child processes.
+// Name                 Not-existing function.
+// Type                 Type of object. Must have default constructor.
+// scope                TTK_FIXTURE_PER_RUN     - single object is shared by all workers, so test functions should only read it. 
+//                                                Construction is synchronized, so other workers wait for it. 
+//                      TTK_FIXTURE_PER_WORKER  - each worker has own object, which can be modified by test functions executed on it.
+// Example:             TTK_FIXTURE(ToWordIndex, WordIndex, TTK_FIXTURE_PER_RUN);
+//                      TTK_TEST(TestFindWord, 0) { TTK_ASSERT(ToWordIndex().Find("word")); }
+#define TTK_FIXTURE(Name, Type, scope) \
+    inline Type& Name() { \
+        static TTK_Fixture<Type> s_fixture(scope); \
+        return s_fixture.Get(); \
+    }
+
+// Declares parameterized test function. Value of executed case is available in its body as 'param' of type const Type&.
+// Cases are added by TTK_ADD_TEST_VALUES, TTK_ADD_TEST_RANGE or TTK_ADD_TEST_GENERATOR.
+// TestFunction         Not-existing test function.
+// Type                 Type of value of case.
+#define TTK_TEST_P(TestFunction, Type) void TestFunction(const Type& param)
+
+// Adds each case of parameterized test function as separate test function, named TestFunction/<case index>.
+// Cases are selected, sharded, executed (also by workers) and reported like any other test functions.
+// Failed case aborts remaining test functions (including remaining cases), unless mode contains TTK_NO_ABORT.
+// TestFunction         Existing parameterized test function of type: void (*)(const Type&).
+// values               Array or container (with begin and end) of values convertible to Type. Values are copied.
+// mode                 Same as in TTK_ADD_TEST, applied to each case.
+#define TTK_ADD_TEST_VALUES(TestFunction, values, mode) TTK_ToSuite().AddTestValues(TestFunction, #TestFunction, values, mode)
+
+// Adds case for each value: begin, begin + step, begin + 2 * step, ... which is lower than end (see TTK_ADD_TEST_VALUES). 
+// Values are calculated when case is executed, so they are not stored.
+// begin, end, step     Values convertible to Type. step must be greater than 0.
+#define TTK_ADD_TEST_RANGE(TestFunction, begin, end, step, mode) TTK_ToSuite().AddTestRange(TestFunction, #TestFunction, begin, end, step, mode)
+
+// Adds number_of_cases cases, which values are made by generator when case is executed (see TTK_ADD_TEST_VALUES). 
+// generator            Function (or lambda without capture) of type: Type (*)(uint64_t case_index). Must be safe to be called concurrently, when executed by workers.
+#define TTK_ADD_TEST_GENERATOR(TestFunction, generator, number_of_cases, mode) TTK_ToSuite().AddTestGenerator(TestFunction, #TestFunction, generator, number_of_cases, mode)
+
 // Executes all test functions.
 // return   true    - if all tests finished without failing any assertion; 
 //          false   - otherwise.
@@ -98,15 +348,194 @@ bool TTK_Run();
 // Removes all tests and frees memory allocations.
 void TTK_Clear();
 
+// Allocates memory for given number of test functions in total, so adding them doesn't allocate. 
+// Test functions are stored in chunks, so adding test function never moves already added ones, regardless of this hint.
+void TTK_ReserveTests(size_t number_of_tests);
+
 // Sets output where all generated communicates (including fail messages) by this library will be sent. Can be stdout, stderr or opened file.
 void TTK_SetOutput(FILE* output);
 
 // Sets output stream orientation for character type. Same parameter rules as in fwide function.
+// Communicates are utf-8 text. For wide orientation, they are converted to utf-16 by this library, without changing locale. 
+// Encoding of wide characters in file is decided by translation mode of the stream (on Windows, for example _setmode(_fileno(output), _O_U8TEXT)).
 // orientation      > 0     - wide      (wchar_t)
 //                    0     - current 
 //                  < 0     - narrow    (char)
 void TTK_ForceOutputOrientation(int orientation);
 
+// Sets number of worker threads which execute test functions.
+// Output (including fail messages) and final summary are the same as for execution on single thread, 
+// but test functions must be safe to be called concurrently.
+// number_of_workers    0       - as many workers as hardware threads,
+//                      1       - test functions are executed one by one on thread which calls TTK_Run (default),
+//                      > 1     - test functions are executed by that many worker threads.
+void TTK_SetNumberOfWorkers(uint32_t number_of_workers);
+
+// Sets whether each test function is executed in separate child process. 
+// Number of child processes executed at the same time is set by TTK_SetNumberOfWorkers.
+// Crash of test function (for example by segmentation fault or abort call) is communicated as failed assertion, and doesn't stop execution of remaining test functions.
+// Available only on systems with fork function (when TTK_PROCESS_ISOLATION_AVAILABLE is defined). Ignored otherwise.
+// is_process_isolation     true    - each test function is executed in child process,
+//                          false   - test functions are executed by current process (default).
+void TTK_SetProcessIsolation(bool is_process_isolation);
+
+// Selects shard of test functions to be executed. Test functions are split between shards by hash of their names, 
+// so the same test function always belongs to the same shard, regardless of machine and order of adding.
+// When shard isn't set by this function, it's taken from environment variables TTK_SHARD_INDEX and TTK_SHARD_COUNT (if both are set).
+// shard_index          Index of shard to be executed, from 0 to number_of_shards - 1.
+// number_of_shards     Number of shards. 0 or 1 - all test functions are executed (default).
+void TTK_SetShard(uint32_t shard_index, uint32_t number_of_shards);
+
+// Adds filter of test functions by name. Test function is executed, if its name matches any include filter (or there is no include filter), 
+// and doesn't match any exclude filter. Filters are applied once at the beginning of TTK_Run, before sharding.
+// Test functions are found through index of sorted names, so filter which starts with literal text (for example "TestParse*") 
+// is checked only against names with that prefix.
+// When no filter is added by this function, filters are taken from environment variable TTK_FILTER, 
+// in form "Include1:Include2-Exclude1:Exclude2" (glob patterns only).
+// pattern      Glob pattern ('*' - any sequence of characters, '?' - any single character) or ECMAScript regular expression.
+//              Whole name must match the pattern.
+// is_exclude   true    - test functions which match pattern are not executed,
+//              false   - only test functions which match pattern (or another include filter) are executed.
+// is_regex     true    - pattern is regular expression,
+//              false   - pattern is glob pattern.
+// Returns false, if pattern is invalid regular expression. Such filter is not added.
+bool TTK_AddFilter(const char* pattern, bool is_exclude = false, bool is_regex = false);
+
+// Removes all filters added by TTK_AddFilter.
+void TTK_ClearFilters();
+
+// Sets filter of test functions by tags (see TTK_TAGGED_TEST). Test function is executed, if its tags satisfy expression. 
+// Filter is applied once at the beginning of TTK_Run, together with filters by name, by bitwise operations on sets of test functions 
+// which have each tag (one bit per test function), so selecting from millions of test functions takes only few passes over memory.
+// When filter isn't set by this function, it's taken from environment variable TTK_TAGS.
+// expression   Names of tags combined by operators (from the highest priority): 'not' or '!', 'and' or '&', 'or' or '|', and parentheses.
+//              For example: "smoke and not slow", "(io | gpu-free) & !slow". Tag which no test function has, matches nothing.
+//              nullptr or empty - filter is removed.
+// Returns false, if expression is invalid. Then filter is not changed.
+bool TTK_SetTagFilter(const char* expression);
+
+// Sets which information about execution time is displayed. Execution time of each test function is always measured (see TTK_GetTestRecords).
+// is_print_test_time       true    - execution time of each test function is displayed after its fails,
+//                          false   - execution time of test functions is not displayed (default).
+// number_of_slowest_tests  Number of the slowest test functions which are listed in summary. 
+//                          Total execution time is added to summary, when this value is greater than 0 or is_print_test_time is true.
+void TTK_SetTimeReport(bool is_print_test_time, uint32_t number_of_slowest_tests);
+
+// Sets timeouts, which are watched during TTK_Run. 
+// When test functions are executed in child processes (see TTK_SetProcessIsolation), then child process of test function which exceeds timeout is killed, 
+// and test function fails with timeout. After run timeout, all executed child processes are killed and remaining test functions are not executed.
+// Otherwise, since thread can't be stopped safely, watchdog thread displays stuck test function (as failed with timeout) 
+// and summary of TTK_Run (reporters are notified as well), and then terminates process with exit code EXIT_FAILURE.
+// test_timeout         Default timeout of each test function, in nanoseconds. Timeout in mode (TTK_TIMEOUT_MS) takes precedence. 0 - no timeout (default).
+// run_timeout          Timeout of whole TTK_Run, in nanoseconds. 0 - no timeout (default).
+void TTK_SetTimeout(uint64_t test_timeout, uint64_t run_timeout);
+
+// Sets limits of failures, after which TTK_Run is cancelled. Then remaining test functions are not started, 
+// child processes of executed test functions are killed (see TTK_SetProcessIsolation) and their test functions are not displayed, 
+// and test functions executed by other workers can finish early by checking TTK_IsCancelled. 
+// Test functions which have already been executed are displayed as usual.
+// max_failed_tests     Number of failed test functions which cancels run. 0 - no limit (default).
+// max_failed_asserts   Number of failed asserts (and expects) which cancels run. 0 - no limit (default).
+void TTK_SetMaxFailures(uint64_t max_failed_tests, uint64_t max_failed_asserts);
+
+// Returns true, if current TTK_Run has been cancelled by limit of failures (see TTK_SetMaxFailures). 
+// Long test function can check it to finish early.
+bool TTK_IsCancelled();
+
+// Sets whether allocations are displayed in summary. Allocations are counted only when allocation hooks are defined (see TTK_ALLOCATION_HOOKS).
+// is_print_allocations     true    - number of allocations, allocated bytes and the highest peak of allocated bytes of single test function are displayed in summary,
+//                          false   - allocations are not displayed (default).
+void TTK_SetAllocationReport(bool is_print_allocations);
+
+enum TTK_BaselineMode {
+    TTK_BASELINE_CHECK,     // times are compared with baselines, time without baseline is only displayed (default)
+    TTK_BASELINE_RECORD,    // times without baseline are recorded, other times are compared with baselines
+    TTK_BASELINE_UPDATE,    // all times are recorded, nothing is compared
+};
+
+// Sets baseline file and mode of TTK_ASSERT_NOT_SLOWER. 
+// Baselines are loaded by first TTK_ASSERT_NOT_SLOWER in TTK_Run and saved at its end, if any has been recorded. 
+// Mode can be overridden by TTK_BASELINE_MODE environment variable with value: check, record or update.
+// file_name_utf8       Path to text file with baselines, one per line: <time in nanoseconds> <key>. 
+//                      If nullptr, then default path is used: TTK_Baselines.txt (in working directory).
+void TTK_SetBaseline(const char* file_name_utf8, TTK_BaselineMode mode);
+
+enum TTK_ResultCacheMode {
+    TTK_CACHE_RUN_ALL,          // all test functions are executed (default)
+    TTK_CACHE_RUN_FAILED,       // only test functions which have failed previously are executed, or all of them if none has failed
+    TTK_CACHE_FAILED_FIRST,     // test functions which have failed previously are executed first, then remaining ones
+    TTK_CACHE_RUN_INCREMENTAL,  // test functions which have passed previously in the same binary (executable) are not executed
+};
+
+// Sets file in which results of test functions are cached, and how cached results select test functions executed by TTK_Run. 
+// Cache is loaded at beginning of TTK_Run and saved at its end. For each test function it holds: name, whether it has failed, duration 
+// and identity of binary (size and modification time of executable). Results of test functions, which haven't been executed, are kept.
+// Mode can be overridden by TTK_RESULT_CACHE_MODE environment variable with value: all, failed, failed_first or incremental.
+// file_name_utf8       Path to cache file. If nullptr, then results are not cached (default).
+void TTK_SetResultCache(const char* file_name_utf8, TTK_ResultCacheMode mode);
+
+// Sets whether test functions are executed from the longest one, by their durations cached by previous runs (see TTK_SetResultCache). 
+// On many workers it shortens run, since long test function isn't started at the end. 
+// Test functions without cached duration are executed first. Previously failed test functions precede them with TTK_CACHE_FAILED_FIRST. 
+// Test functions with TTK_KEEP_ORDER in mode aren't moved.
+// is_longest_first     true    - test functions are ordered by cached durations, 
+//                      false   - test functions are executed in order of adding (default).
+void TTK_SetLongestFirst(bool is_longest_first);
+
+struct TTK_TestRecord;
+
+// Returns records of test functions executed by last TTK_Run, in order of execution. 
+// Records are valid until next TTK_Run or TTK_Clear.
+const std::vector<TTK_TestRecord>& TTK_GetTestRecords();
+
+// Returns execution time of all test functions by last TTK_Run, in nanoseconds.
+uint64_t TTK_GetTotalTime();
+
+// Sets how benchmark functions are measured.
+// min_sample_time      Minimal time of single sample, in nanoseconds (default 10 ms).
+// number_of_samples    Number of samples from which results are calculated (default 10).
+void TTK_SetBenchmarkConfig(uint64_t min_sample_time, uint32_t number_of_samples);
+
+// Prevents compiler from optimizing out value, or calculation of value, in benchmark function.
+template <typename Type>
+void TTK_DoNotOptimize(Type&& value);
+
+// Prevents compiler from reordering or eliminating writes to memory around place of call.
+void TTK_ClobberMemory();
+
+// Sets how properties are checked (see TTK_PROPERTY).
+// number_of_cases      Maximal number of cases checked per property (default 1000). If 0, then number of cases is limited by max_time only.
+// max_time             Maximal time of checking single property, in nanoseconds. If 0, then there is no time limit (default).
+// seed                 Seed of random values. If 0, then seed is taken from TTK_PROPERTY_SEED environment variable, 
+//                      or (if it's not set) is different at each TTK_Run (default). Seed is reported with counterexample, so it can be reproduced.
+void TTK_SetPropertyConfig(uint64_t number_of_cases, uint64_t max_time, uint64_t seed);
+
+// Checks property function for random values made by generator (see TTK_PROPERTY). Can be called from any test function.
+// name                 Name of property, mixed into seed, so different properties get different values.
+template <typename GeneratorType>
+void TTK_CheckProperty(const GeneratorType& generator, void (*property)(const typename GeneratorType::Value_T& param), const char* name);
+
+enum TTK_OutputMode {
+    TTK_OUTPUT_DIRECT,      // each communicate is written to output and flushed immediately (default)
+    TTK_OUTPUT_BUFFERED,    // communicates are gathered in memory and written in large batches
+    TTK_OUTPUT_ASYNC,       // communicates are gathered in memory and written in large batches by background thread
+};
+
+// Sets how communicates are written to output.
+// In buffered modes, output is still flushed after each fail, and at the end of TTK_Run. 
+// When process is terminated by signal (for example by segmentation fault), gathered communicates are written before termination (best effort).
+// mode         TTK_OUTPUT_DIRECT, TTK_OUTPUT_BUFFERED or TTK_OUTPUT_ASYNC.
+// buffer_size  Size of gathered communicates (in bytes), at which they are written to output (default 64 KiB).
+void TTK_SetOutputMode(TTK_OutputMode mode, size_t buffer_size = 1 << 16);
+
+class TTK_Reporter;
+
+// Attaches reporter, which receives events of TTK_Run (run begin, test begin, assert fail, note, test end, run end). 
+// Several reporters can be attached at once, and they receive events in order of attaching. Text output is not affected.
+// Reporters shipped with library: TTK_JUnitReporter (JUnit XML) and TTK_JSONLinesReporter (one json object per line).
+// Reporter is not owned by library, and must exist until TTK_Clear, which detaches all reporters.
+void TTK_AddReporter(TTK_Reporter* reporter);
+
 //==============================================================================
 // Inner
 //==============================================================================
@@ -119,290 +548,5370 @@ void TTK_ForceOutputOrientation(int orientation);
 #define TTK_INNER_U8(text) reinterpret_cast<const char*>(u8##text)
 #define TTK_U8(text) TTK_INNER_U8(text)
 
+#define TTK_INNER_CONCAT(left, right) left##right
+#define TTK_CONCAT(left, right) TTK_INNER_CONCAT(left, right)
+
+// Block of user is executed by inner loop. Then outer loop checks allocations, also when block has been left by break or continue.
+#define TTK_INNER_ASSERT_ALLOCS(scope, max_number_of_allocations, condition) \
+    for (TTK_AllocationScope scope(max_number_of_allocations); !scope.IsChecked(); ) \
+        if (scope.IsEntered()) { \
+            TTK_ToNumberOfExecutedAsserts() += 1; \
+            if (TTK_UNLIKELY(!scope.Check())) { scope.Fail(__LINE__, condition, TTK_U8(__FILE__)); return; } \
+        } else \
+            for (; scope.Enter(); )
+
+#define TTK_INNER_ASSERT_NOT_SLOWER(scope, key, tolerance, condition) \
+    for (TTK_TimingScope scope(key, tolerance); !scope.IsChecked(); ) \
+        if (scope.IsMeasured()) { \
+            TTK_ToNumberOfExecutedAsserts() += 1; \
+            if (TTK_UNLIKELY(!scope.Check())) { scope.Fail(__LINE__, condition, TTK_U8(__FILE__)); return; } \
+        } else \
+            for (; scope.KeepRunning(); )
+
+#define TTK_INNER_ASSERT_COMPARE(left, right, operation, condition, is_assert, on_fail) \
+    { \
+        TTK_ToNumberOfExecutedAsserts() += 1; \
+        const auto& ttk_left = (left); \
+        const auto& ttk_right = (right); \
+        if (TTK_UNLIKELY(!(ttk_left operation ttk_right))) { TTK_CompareFail(is_assert, __LINE__, condition, TTK_U8(__FILE__), ttk_left, ttk_right); on_fail } \
+    } (void)0
+
+#define TTK_INNER_ASSERT_MEM_EQ(left, right, size, condition, is_assert, on_fail) \
+    { \
+        TTK_ToNumberOfExecutedAsserts() += 1; \
+        const void* const ttk_left = (left); \
+        const void* const ttk_right = (right); \
+        const size_t ttk_size = (size); \
+        if (TTK_UNLIKELY(!TTK_IsMemoryEqual(ttk_left, ttk_right, ttk_size))) { TTK_MemoryFail(is_assert, __LINE__, condition, TTK_U8(__FILE__), ttk_left, ttk_right, ttk_size); on_fail } \
+    } (void)0
+
+#define TTK_INNER_ASSERT_RANGE_EQ(left, right, condition, is_assert, on_fail) \
+    { \
+        TTK_ToNumberOfExecutedAsserts() += 1; \
+        const auto& ttk_left = (left); \
+        const auto& ttk_right = (right); \
+        if (TTK_UNLIKELY(!TTK_IsRangeEqual(ttk_left, ttk_right))) { TTK_RangeFail(is_assert, __LINE__, condition, TTK_U8(__FILE__), ttk_left, ttk_right); on_fail } \
+    } (void)0
+
+#define TTK_INNER_ASSERT_ARRAY_NEAR(actual, expected, size, tolerance, min_magnitude, kind, condition, is_assert, on_fail) \
+    { \
+        TTK_ToNumberOfExecutedAsserts() += 1; \
+        const auto ttk_actual = (actual); \
+        const auto ttk_expected = (expected); \
+        const size_t ttk_size = (size); \
+        const double ttk_tolerance = double(tolerance); \
+        const double ttk_min_magnitude = double(min_magnitude); \
+        if (TTK_UNLIKELY(!TTK_IsArrayNear(ttk_actual, ttk_expected, ttk_size, ttk_tolerance, ttk_min_magnitude, kind))) { TTK_ArrayNearFail(is_assert, __LINE__, condition, TTK_U8(__FILE__), ttk_actual, ttk_expected, ttk_size, ttk_tolerance, ttk_min_magnitude, kind); on_fail } \
+    } (void)0
+
 //------------------------------------------------------------------------------
 
 // Test function pointer type.
 using TTK_TestFnP_T = void (*)();
 
+// Executes case of parameterized test function.
+using TTK_CaseFnP_T = void (*)(const void* case_set, uint64_t case_index);
+
 struct TTK_TestData{
     TTK_TestFnP_T   function;
     const char*     name;
     uint64_t        mode;      // bitfield
+
+    // Set for case of parameterized test function, then 'function' is not used.
+    TTK_CaseFnP_T   case_function;
+    const void*     case_set;
+    uint64_t        case_index;
+
+    const char*     tags;       // names of tags separated by spaces or commas (see TTK_SetTagFilter), or nullptr
 };
 
-//------------------------------------------------------------------------------
+// Record of test function declared by TTK_TEST, when TTK_STATIC_REGISTRATION is in use.
+struct TTK_StaticTest {
+    TTK_TestData    test_data;
+    const char*     file_name;
+    unsigned        line;
+};
 
-class TTK_Register {
-public:
-    using SizeType = std::vector<TTK_TestData>::size_type;
+// Linker section contains only pointers to records. Pointers have natural alignment, so compiler doesn't add gaps between them, 
+// and gaps added by MSVC linker between sections from different object files are filled with null pointers.
+// Bounds of section are declared regardless of TTK_STATIC_REGISTRATION, so translation units with and without it can be linked together.
+#if defined(_MSC_VER)
+#pragma section(".ttk$a", read)
+#pragma section(".ttk$m", read)
+#pragma section(".ttk$z", read)
 
-    TTK_Register() {}
-    virtual ~TTK_Register() {}
+// Grouped sections are ordered by name after '$', so these markers surround all records.
+extern "C" __declspec(allocate(".ttk$a")) __declspec(selectany) const TTK_StaticTest* const TTK_g_static_tests_begin = nullptr;
+extern "C" __declspec(allocate(".ttk$z")) __declspec(selectany) const TTK_StaticTest* const TTK_g_static_tests_end = nullptr;
 
-    bool AddTest(const TTK_TestData& test_data) {
-        if (m_tests.max_size() == m_tests.size()) {
-            return false;
-        }
-        m_tests.push_back(test_data);
-        return true;
-    }
+#if defined(TTK_STATIC_REGISTRATION)
+#define TTK_STATIC_REGISTRATION_AVAILABLE
 
-    TTK_TestData& ToTest(SizeType index) {
-        return m_tests[index];
-    }
+#define TTK_INNER_STATIC_TEST_SECTION __declspec(allocate(".ttk$m"))
 
-    const TTK_TestData& ToTest(SizeType index) const {
-        return m_tests[index];
-    }
+// Nothing refers to entry, so linker would discard it with /OPT:REF (and /Gw or /GL). Name of C symbol on x86 starts with '_'.
+#if defined(_M_IX86)
+#define TTK_INNER_KEEP_STATIC_TEST_ENTRY(entry) __pragma(comment(linker, "/include:_" #entry))
+#else
+#define TTK_INNER_KEEP_STATIC_TEST_ENTRY(entry) __pragma(comment(linker, "/include:" #entry))
+#endif
+#endif
 
-    SizeType GetNumberOfTests() const {
-        return m_tests.size();
-    }
+#elif defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+// Defined by linker, when section 'ttk_tests' exists.
+extern "C" const TTK_StaticTest* const __start_ttk_tests[] __attribute__((weak, visibility("hidden")));
+extern "C" const TTK_StaticTest* const __stop_ttk_tests[] __attribute__((weak, visibility("hidden")));
 
-    SizeType GetMaxNumberOfTests() const {
-        return m_tests.max_size();
-    }
+#if defined(TTK_STATIC_REGISTRATION)
+#define TTK_STATIC_REGISTRATION_AVAILABLE
 
-    void Clear() {
-        m_tests.clear();
-    }
+#define TTK_INNER_STATIC_TEST_SECTION __attribute__((used, section("ttk_tests")))
 
-private:
-    std::vector<TTK_TestData> m_tests;
-};
+#define TTK_INNER_KEEP_STATIC_TEST_ENTRY(entry)
+#endif
+#endif
 
-//------------------------------------------------------------------------------
+#if defined(TTK_STATIC_REGISTRATION_AVAILABLE)
+// Records have external linkage (like test functions), so they are never discarded by compiler.
+// Entries have C linkage, so linker can be told to keep them by their names.
+#define TTK_INNER_REGISTER_TEST(Name, test_function, mode, tags) \
+    extern const TTK_StaticTest TTK_static_test_##Name; \
+    const TTK_StaticTest TTK_static_test_##Name = {{test_function, #Name, mode, nullptr, nullptr, 0, tags}, __FILE__, __LINE__}; \
+    extern "C" const TTK_StaticTest* const TTK_static_test_entry_##Name; \
+    TTK_INNER_KEEP_STATIC_TEST_ENTRY(TTK_static_test_entry_##Name) \
+    TTK_INNER_STATIC_TEST_SECTION const TTK_StaticTest* const TTK_static_test_entry_##Name = &TTK_static_test_##Name
+#else
+#define TTK_INNER_REGISTER_TEST(Name, test_function, mode, tags) \
+    static bool s_is_force_called_before_main_##Name = (TTK_ToSuite().AddTest({test_function, #Name, mode, nullptr, nullptr, 0, tags}), true)
+#endif
 
-class TTK_LocaleGuardianUTF8 {
-public:
-    TTK_LocaleGuardianUTF8() {
-        const char* locale = setlocale(LC_ALL, nullptr);
-        if (locale) m_prev_locale_backup = locale;
+// Returns records of test functions placed in linker section (see TTK_STATIC_REGISTRATION). Null pointers must be skipped.
+inline std::pair<const TTK_StaticTest* const*, const TTK_StaticTest* const*> TTK_GetStaticTests() {
+#if defined(_MSC_VER)
+    return {&TTK_g_static_tests_begin + 1, &TTK_g_static_tests_end};
+#elif defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+    return {__start_ttk_tests, __stop_ttk_tests};
+#else
+    return {nullptr, nullptr};
+#endif
+}
 
-        setlocale(LC_ALL, ".utf8");
-    }
+enum TTK_CommunicateKind {
+    TTK_COMMUNICATE_KIND_ASSERT_FAIL,   // condition of assertion is false
+    TTK_COMMUNICATE_KIND_CRASH,         // child process which executes test function has been terminated, 'message' contains the reason
+    TTK_COMMUNICATE_KIND_TIMEOUT,       // test function has exceeded timeout, 'message' contains the timeout
+    TTK_COMMUNICATE_KIND_NOTE,          // additional information about test function (for example benchmark result), 'message' contains text to be displayed
+};
 
-    virtual ~TTK_LocaleGuardianUTF8() {
-        setlocale(LC_ALL, m_prev_locale_backup.c_str());
-    }
+// Information about test function executed by TTK_Run.
+struct TTK_TestRecord {
+    const char*     name;
+    uint64_t        duration;       // in nanoseconds
+    bool            is_fail;
 
-private:
-    std::string m_prev_locale_backup;
+    // Counted only when allocation hooks are defined (see TTK_ALLOCATION_HOOKS).
+    uint64_t        number_of_allocations;
+    uint64_t        allocated_bytes;
+    uint64_t        peak_allocated_bytes;
 };
 
-// Enables unicode codepage for functions which belongs to printf family in a code scope, where it's placed. 
-// Restores previous codepage when exits the code scope.
-#define TTK_GuardLocaleUTF8() TTK_LocaleGuardianUTF8 locale_guardian_utf8
+// Information about failed assertion or other event in test function.
+// Stored when test function is executed by worker, and communicated later in order of adding test functions.
+struct TTK_CommunicateData {
+    TTK_CommunicateKind kind;
+    unsigned        line;
+    const char*     condition;
+    const char*     file_name_utf8;
+    std::string     message;
+    bool            is_message;
+};
 
-//------------------------------------------------------------------------------
+// Result of single execution of test function.
+struct TTK_TestResult {
+    uint64_t                        number_of_executed_asserts;
+    uint64_t                        number_of_failed_asserts;
 
-#if defined(_MSC_VER)      
-#define TTK_TRY_FORCE_NON_INLINE __declspec(noinline)
-#elif defined(__GNUC__) 
-#define TTK_TRY_FORCE_NON_INLINE __attribute__((noinline))
-#else
-#define TTK_TRY_FORCE_NON_INLINE
-#endif
+    uint64_t                        duration;           // in nanoseconds
 
-//------------------------------------------------------------------------------
+    uint64_t                        number_of_allocations;
+    uint64_t                        allocated_bytes;
+    uint64_t                        peak_allocated_bytes;
 
-class TTK_Suite {
+    bool                            is_request_abort;
+    bool                            is_deferred;        // if true, then communicates are stored in 'communicates' instead of being displayed immediately
+
+    std::vector<TTK_CommunicateData> communicates;
+
+    std::vector<std::pair<std::string, double>> recorded_baselines;    // sent by child process, key and time in nanoseconds
+};
+
+// Summary of TTK_Run.
+struct TTK_RunSummary {
+    uint64_t        number_of_executed_asserts;
+    uint64_t        number_of_failed_asserts;
+    uint64_t        number_of_executed_tests;
+    uint64_t        number_of_failed_tests;
+    uint64_t        total_time;     // in nanoseconds
+    bool            is_success;
+};
+
+// Receives events of TTK_Run. Events are delivered on thread which calls TTK_Run, in order of test functions, 
+// the same as text output. When test functions are executed by workers or in child processes, 
+// all events of test function are delivered after it has finished.
+class TTK_Reporter {
 public:
-    TTK_Suite() {
-        m_output                        = stdout;
+    virtual ~TTK_Reporter() {}
 
-        m_number_of_executed_asserts    = 0;
-        m_number_of_failed_asserts      = 0;
+    // number_of_tests  Number of test functions selected to be executed.
+    virtual void OnRunBegin(uint64_t number_of_tests) { (void)number_of_tests; }
 
-        m_number_of_executed_tests      = 0;
-        m_number_of_failed_tests        = 0;
+    virtual void OnTestBegin(const TTK_TestData& test_data) { (void)test_data; }
 
-        m_forced_orientation            = false;
+    // Called for failed assertion (TTK_COMMUNICATE_KIND_ASSERT_FAIL), crash of test function (TTK_COMMUNICATE_KIND_CRASH) 
+    // and exceeded timeout (TTK_COMMUNICATE_KIND_TIMEOUT). 
+    // Can be also called for assertion executed outside of test function.
+    virtual void OnAssertFail(const TTK_CommunicateData& communicate) { (void)communicate; }
 
-        m_is_request_abort              = false;
-        m_is_max_test_num_reached       = false;
-        
-    }
+    // Called for additional information about test function (for example benchmark result).
+    virtual void OnNote(const std::string& text) { (void)text; }
 
-    virtual ~TTK_Suite() {
-        if (m_output) fclose(m_output);
-    }
+    virtual void OnTestEnd(const TTK_TestData& test_data, const TTK_TestResult& test_result) { (void)test_data; (void)test_result; }
 
-    void AddTest(const TTK_TestData& test_data) {
-        if (!m_tests.AddTest(test_data)) {
-            m_is_max_test_num_reached = true;
-        }
-    }
+    virtual void OnRunEnd(const TTK_RunSummary& summary) { (void)summary; }
+};
 
-    void Clear() {
-        m_tests.Clear();
-        m_is_max_test_num_reached = false;
-    }
+// Number of asserts executed by current test function on this thread. 
+// Counted without any synchronization or call, so passing assertion costs single increment and branch.
+inline uint64_t& TTK_ToNumberOfExecutedAsserts() {
+    static thread_local uint64_t s_number_of_executed_asserts = 0;
+    return s_number_of_executed_asserts;
+}
 
-    TTK_TRY_FORCE_NON_INLINE
-    void CommunicateAssertFail(unsigned line, const char* condition, const wchar_t* file_name_utf16, const char* file_name_utf8, const char* message) {
-        TTK_GuardLocaleUTF8();
+// Index of worker which executes test functions on this thread (0 for calling thread of TTK_Run).
+inline uint32_t& TTK_ToWorkerIndex() {
+    static thread_local uint32_t s_worker_index = 0;
+    return s_worker_index;
+}
 
-        m_number_of_failed_asserts += 1;
+// Result of test function which is currently executed on this thread. Is nullptr outside of test function execution.
+inline TTK_TestResult*& TTK_ToCurrentTestResult() {
+    static thread_local TTK_TestResult* s_test_result = nullptr;
+    return s_test_result;
+}
 
-        if (m_output) {
-            if (SolveOutputOrientation() > 0) {
-                fwprintf(m_output, L"    [fail] [file:%s] [line:%d] [condition:%hs]", file_name_utf16, line, condition);
-                if (message) {
-                    fwprintf(m_output, L" [message:%hs]\n", message);
-                } else {
-                    fwprintf(m_output, L"\n");
-                }
-            } else {
-                fprintf(m_output, "    [fail] [file:%s] [line:%d] [condition:%s]", file_name_utf8, line, condition);
-                if (message) {
-                    fprintf(m_output, " [message:%s]\n", message);
-                } else {
-                    fprintf(m_output, "\n");
-                }
-            }
-            fflush(m_output);
-        }
-    }
+struct TTK_AllocationCounters {
+    uint64_t    number_of_allocations;
+    uint64_t    allocated_bytes;
+    int64_t     current_bytes;      // allocated minus freed bytes, negative when memory allocated earlier (or by other thread) is freed
+    int64_t     peak_bytes;         // the highest current_bytes
+};
 
-    void CommunicateAssertFail(unsigned line, const char* condition, const wchar_t* file_name_utf16, const char* file_name_utf8, const std::string& message) {
-        CommunicateAssertFail(line, condition, file_name_utf16, file_name_utf8, message.c_str());
-    }
+// Allocations made on this thread, counted by allocation hooks (see TTK_ALLOCATION_HOOKS).
+inline TTK_AllocationCounters& TTK_ToAllocationCounters() {
+    static thread_local TTK_AllocationCounters s_allocation_counters = {};
+    return s_allocation_counters;
+}
 
-    bool Run() {
-        bool is_success = false;
+// Is true, when allocation hooks are defined in program.
+inline bool& TTK_ToIsAllocationCounted() {
+    static bool s_is_allocation_counted = false;
+    return s_is_allocation_counted;
+}
 
-        if (m_is_max_test_num_reached) {
-            if (SolveOutputOrientation() > 0) {
-                fwprintf(m_output, L"TTK Error: Max number of test (%llu) has been reached.", (uint64_t)m_tests.GetMaxNumberOfTests());
-            } else {
-                fprintf(m_output, "TTK Error: Max number of test (%llu) has been reached.", (uint64_t)m_tests.GetMaxNumberOfTests());
-            }
-        } else {
-            m_number_of_executed_asserts = 0;
-            m_number_of_failed_asserts   = 0;
+inline void TTK_CountAllocation(size_t size) {
+    TTK_AllocationCounters& counters = TTK_ToAllocationCounters();
 
-            m_number_of_executed_tests   = 0;
-            m_number_of_failed_tests     = 0;
+    counters.number_of_allocations  += 1;
+    counters.allocated_bytes        += size;
+    counters.current_bytes          += int64_t(size);
+    if (counters.current_bytes > counters.peak_bytes) counters.peak_bytes = counters.current_bytes;
+}
 
-            m_is_request_abort           = false;
+inline void TTK_CountFree(size_t size) {
+    TTK_ToAllocationCounters().current_bytes -= int64_t(size);
+}
 
-            if (SolveOutputOrientation() > 0) {
-                fwprintf(m_output, L"%hs", "--- TEST ---\n");
-            } else {
-                fprintf(m_output, "%s", "--- TEST ---\n");
-            }
+// Returns time from monotonic clock, in nanoseconds.
+inline uint64_t TTK_GetTime() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
 
-            uint64_t previous_number_of_failed_asserts = 0;
+//------------------------------------------------------------------------------
 
-            for (TTK_Register::SizeType index = 0; index < m_tests.GetNumberOfTests(); ++index) {
-                TTK_TestData& test_data = m_tests.ToTest(index);
+// Fixture declared by TTK_FIXTURE. Constructed objects of fixture are destroyed by suite at the end of TTK_Run.
+class TTK_FixtureBase {
+public:
+    virtual ~TTK_FixtureBase() {}
 
-                if (!(test_data.mode & TTK_DISABLE)) {
-                    if (SolveOutputOrientation() > 0) {
-                        fwprintf(m_output, L"[test] %hs\n", test_data.name);
-                    } else {
-                        fprintf(m_output, "[test] %s\n", test_data.name);
-                    }
-                    fflush(m_output);
+    // Destroys all constructed objects of fixture.
+    virtual void Destroy() = 0;
+};
 
-                    test_data.function();
+//------------------------------------------------------------------------------
 
-                    m_number_of_executed_tests += 1;
-                    if (m_number_of_failed_asserts != previous_number_of_failed_asserts) { 
-                        previous_number_of_failed_asserts = m_number_of_failed_asserts;
-                        m_number_of_failed_tests += 1;
+// Storage of cases of parameterized test function, owned by suite.
+class TTK_CaseSet {
+public:
+    TTK_CaseSet() {}
+    virtual ~TTK_CaseSet() {}
 
-                        if (m_is_request_abort) {
-                            m_is_request_abort = false;
-                            if (!(test_data.mode & TTK_NO_ABORT)) break; // abort all tests
-                        }
-                    }
-                }
-            }
+    // Makes names of cases: name/0, name/1, ... in single buffer, one after another.
+    // Returns the first name.
+    const char* MakeNames(const char* name, uint64_t number_of_cases) {
+        const size_t name_length = strlen(name);
 
-            is_success = m_number_of_failed_tests == 0;
+        size_t size = 0;
+        for (uint64_t case_index = 0; case_index < number_of_cases; ++case_index) {
+            size += name_length + 1 + CountDigits(case_index) + 1;
+        }
 
-            if (SolveOutputOrientation() > 0) {
-                fwprintf(m_output, L"%hs", (is_success ? "--- TEST SUCCESS ---\n" : "--- TEST FAIL ---\n"));
-                fwprintf(m_output, L"number of executed asserts      : %lld\n", m_number_of_executed_asserts);
-                fwprintf(m_output, L"number of failed asserts        : %lld\n", m_number_of_failed_asserts);
-                fwprintf(m_output, L"number of executed tests        : %lld\n", m_number_of_executed_tests);
-                fwprintf(m_output, L"number of failed tests          : %lld\n", m_number_of_failed_tests);
-            } else {
-                fprintf(m_output, "%s", (is_success ? "--- TEST SUCCESS ---\n" : "--- TEST FAIL ---\n"));
-                fprintf(m_output, "number of executed asserts      : %lld\n", m_number_of_executed_asserts);
-                fprintf(m_output, "number of failed asserts        : %lld\n", m_number_of_failed_asserts);
-                fprintf(m_output, "number of executed tests        : %lld\n", m_number_of_executed_tests);
-                fprintf(m_output, "number of failed tests          : %lld\n", m_number_of_failed_tests);
-            }
+        m_names.resize(size);
+        char* case_name = m_names.data();
+        for (uint64_t case_index = 0; case_index < number_of_cases; ++case_index) {
+            const size_t case_name_size = name_length + 1 + CountDigits(case_index) + 1;
+            snprintf(case_name, case_name_size, "%s/%llu", name, (unsigned long long)case_index);
+            case_name += case_name_size;
         }
 
-        return is_success;
+        return m_names.data();
     }
 
-
-    void SetOutput(FILE* output) {
-        m_output = output;
+private:
+    static size_t CountDigits(uint64_t value) {
+        size_t number_of_digits = 1;
+        for (; value >= 10; value /= 10) ++number_of_digits;
+        return number_of_digits;
     }
 
-    void ForceOutputOrientation(int orientation) {
-        m_forced_orientation = orientation;
-    }
+    std::vector<char> m_names;
+};
 
-    void RequestAbort() {
-        m_is_request_abort = true;
+template <typename Type>
+class TTK_ValueCaseSet : public TTK_CaseSet {
+public:
+    using FunctionP_T = void (*)(const Type&);
+
+    TTK_ValueCaseSet(FunctionP_T function, std::vector<Type>&& values) {
+        m_function  = function;
+        m_values    = std::move(values);
     }
 
-    void IncNumOfAssertExecutions() {
-        m_number_of_executed_asserts += 1;
+    virtual ~TTK_ValueCaseSet() {}
+
+    static void Execute(const void* case_set, uint64_t case_index) {
+        const TTK_ValueCaseSet& self = *static_cast<const TTK_ValueCaseSet*>(case_set);
+        self.m_function(self.m_values[case_index]);
     }
 
 private:
-    int SolveOutputOrientation() {
-        if (m_forced_orientation != 0) return m_forced_orientation;
-        return fwide(m_output, 0);
+    FunctionP_T         m_function;
+    std::vector<Type>   m_values;
+};
+
+template <typename Type>
+class TTK_RangeCaseSet : public TTK_CaseSet {
+public:
+    using FunctionP_T = void (*)(const Type&);
+
+    TTK_RangeCaseSet(FunctionP_T function, const Type& begin, const Type& step) {
+        m_function  = function;
+        m_begin     = begin;
+        m_step      = step;
     }
 
-    FILE*           m_output;
+    virtual ~TTK_RangeCaseSet() {}
 
-    uint64_t        m_number_of_executed_asserts;
-    uint64_t        m_number_of_failed_asserts;
+    static void Execute(const void* case_set, uint64_t case_index) {
+        const TTK_RangeCaseSet& self = *static_cast<const TTK_RangeCaseSet*>(case_set);
+        self.m_function(Type(self.m_begin + Type(case_index) * self.m_step));
+    }
 
-    uint64_t        m_number_of_executed_tests;
-    uint64_t        m_number_of_failed_tests;
+private:
+    FunctionP_T         m_function;
+    Type                m_begin;
+    Type                m_step;
+};
+
+template <typename Type>
+class TTK_GeneratorCaseSet : public TTK_CaseSet {
+public:
+    using FunctionP_T   = void (*)(const Type&);
+    using GeneratorP_T  = Type (*)(uint64_t case_index);
 
-    int             m_forced_orientation;
+    TTK_GeneratorCaseSet(FunctionP_T function, GeneratorP_T generator) {
+        m_function  = function;
+        m_generator = generator;
+    }
 
-    bool            m_is_request_abort;
-    bool            m_is_max_test_num_reached;
+    virtual ~TTK_GeneratorCaseSet() {}
 
-    TTK_Register    m_tests;
+    static void Execute(const void* case_set, uint64_t case_index) {
+        const TTK_GeneratorCaseSet& self = *static_cast<const TTK_GeneratorCaseSet*>(case_set);
+        self.m_function(self.m_generator(case_index));
+    }
+
+private:
+    FunctionP_T         m_function;
+    GeneratorP_T        m_generator;
 };
 
+// Prevents deduction of template parameter from function argument.
+template <typename Type>
+struct TTK_NonDeduced {
+    using Type_T = Type;
+};
 
 //------------------------------------------------------------------------------
 
-inline TTK_Suite& TTK_ToSuite() {
-    static TTK_Suite s_suite;
-    return s_suite;
-}
+// Stores tests in chunks of fixed size. Adding test never moves already added tests, so references returned by ToTest stay valid until Clear.
+class TTK_Register {
+public:
+    using SizeType = std::vector<TTK_TestData>::size_type;
 
-inline bool TTK_Run() {
-    return TTK_ToSuite().Run();
-}
+    TTK_Register() {
+        m_number_of_tests       = 0;
+        m_is_tag_index_built    = false;
+    }
 
-inline void TTK_Clear() {
-    TTK_ToSuite().Clear();
-}
+    virtual ~TTK_Register() {}
 
-inline void TTK_SetOutput(FILE* output) {
-    TTK_ToSuite().SetOutput(output);
-}
+    bool AddTest(const TTK_TestData& test_data) {
+        if (m_number_of_tests == GetMaxNumberOfTests()) {
+            return false;
+        }
+        if (m_number_of_tests == GetCapacity()) {
+            m_chunks.push_back(std::unique_ptr<TTK_TestData[]>(new TTK_TestData[CHUNK_SIZE]));
+        }
 
-inline void TTK_ForceOutputOrientation(int orientation) {
-    TTK_ToSuite().ForceOutputOrientation(orientation);
+        ToTest(m_number_of_tests) = test_data;
+        m_number_of_tests += 1;
+
+        m_sorted_by_name.clear();
+        m_is_tag_index_built = false;
+        return true;
+    }
+
+    // Allocates memory for at least number_of_tests tests in total.
+    void Reserve(SizeType number_of_tests) {
+        number_of_tests = std::min(number_of_tests, GetMaxNumberOfTests());
+
+        m_chunks.reserve((number_of_tests + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        while (GetCapacity() < number_of_tests) {
+            m_chunks.push_back(std::unique_ptr<TTK_TestData[]>(new TTK_TestData[CHUNK_SIZE]));
+        }
+    }
+
+    TTK_TestData& ToTest(SizeType index) {
+        return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+
+    const TTK_TestData& ToTest(SizeType index) const {
+        return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+
+    SizeType GetNumberOfTests() const {
+        return m_number_of_tests;
+    }
+
+    SizeType GetCapacity() const {
+        return m_chunks.size() * CHUNK_SIZE;
+    }
+
+    SizeType GetMaxNumberOfTests() const {
+        return std::min<SizeType>(m_chunks.max_size(), SizeType(-1) / CHUNK_SIZE) * CHUNK_SIZE;
+    }
+
+    void Clear() {
+        std::vector<std::unique_ptr<TTK_TestData[]>>().swap(m_chunks);
+        m_number_of_tests = 0;
+        std::vector<SizeType>().swap(m_sorted_by_name);
+        std::vector<TagColumn>().swap(m_tag_columns);
+        m_is_tag_index_built = false;
+    }
+
+    // Adds test functions from records, ordered by source file name and line. Null records are skipped.
+    // Inserted in front of already added tests, because they are declared before main.
+    void AddStaticTests(const TTK_StaticTest* const* begin, const TTK_StaticTest* const* end) {
+        std::vector<const TTK_StaticTest*> static_tests;
+        static_tests.reserve(end - begin);
+        for (; begin != end; ++begin) {
+            if (*begin) static_tests.push_back(*begin);
+        }
+        if (static_tests.empty()) return;
+
+        std::sort(static_tests.begin(), static_tests.end(), [](const TTK_StaticTest* l, const TTK_StaticTest* r) {
+            const int order = (l->file_name == r->file_name) ? 0 : strcmp(l->file_name, r->file_name);
+            return order != 0 ? order < 0 : l->line < r->line;
+        });
+
+        std::vector<TTK_TestData> tests;
+        tests.reserve(m_number_of_tests);
+        for (SizeType index = 0; index < m_number_of_tests; ++index) tests.push_back(ToTest(index));
+
+        Clear();
+        Reserve(static_tests.size() + tests.size());
+        for (const TTK_StaticTest* static_test : static_tests) AddTest(static_test->test_data);
+        for (const TTK_TestData& test_data : tests) AddTest(test_data);
+    }
+
+    // Finds tests which name starts with prefix.
+    // Returns range in index of tests sorted by name. Index is built at first call after tests have been changed.
+    std::pair<const SizeType*, const SizeType*> FindByNamePrefix(const std::string& prefix) {
+        if (m_sorted_by_name.size() != m_number_of_tests) {
+            m_sorted_by_name.resize(m_number_of_tests);
+            for (SizeType index = 0; index < m_number_of_tests; ++index) m_sorted_by_name[index] = index;
+
+            std::sort(m_sorted_by_name.begin(), m_sorted_by_name.end(), [&](SizeType l, SizeType r) {
+                return strcmp(ToTest(l).name, ToTest(r).name) < 0;
+            });
+        }
+
+        const SizeType* begin   = m_sorted_by_name.data();
+        const SizeType* end     = begin + m_sorted_by_name.size();
+
+        if (!prefix.empty()) {
+            begin = std::lower_bound(begin, end, prefix, [&](SizeType index, const std::string& value) {
+                return strcmp(ToTest(index).name, value.c_str()) < 0;
+            });
+            end = std::upper_bound(begin, end, prefix, [&](const std::string& value, SizeType index) {
+                return strncmp(value.c_str(), ToTest(index).name, value.size()) < 0;
+            });
+        }
+
+        return {begin, end};
+    }
+
+    // Finds set of tests which have tag. Test of index has bit (index % 64) in word (index / 64). 
+    // Returns nullptr, if no test has tag. Index of tags is built at first call after tests have been changed.
+    const std::vector<uint64_t>* FindTestsByTag(const std::string& tag) {
+        if (!m_is_tag_index_built) BuildTagIndex();
+
+        const std::vector<TagColumn>::const_iterator column = std::lower_bound(m_tag_columns.begin(), m_tag_columns.end(), tag, [](const TagColumn& l, const std::string& r) {
+            return l.tag < r;
+        });
+        return (column != m_tag_columns.end() && column->tag == tag) ? &column->tests : nullptr;
+    }
+
+    // Returns number of 64-bit words in set of tests.
+    SizeType GetNumberOfWords() const {
+        return (m_number_of_tests + 63) / 64;
+    }
+
+private:
+    enum : SizeType { CHUNK_SIZE = 4096 };  // number of tests in chunk, power of 2
+
+    // Tests which have tag, as bitset.
+    struct TagColumn {
+        std::string             tag;
+        std::vector<uint64_t>   tests;
+    };
+
+    void BuildTagIndex() {
+        std::vector<TagColumn>().swap(m_tag_columns);
+
+        for (SizeType index = 0; index < m_number_of_tests; ++index) {
+            const char* tags = ToTest(index).tags;
+            if (!tags) continue;
+
+            while (*tags) {
+                const size_t length = strcspn(tags, " ,\t");
+                if (length > 0) {
+                    const std::string tag(tags, length);
+
+                    std::vector<TagColumn>::iterator column = std::lower_bound(m_tag_columns.begin(), m_tag_columns.end(), tag, [](const TagColumn& l, const std::string& r) {
+                        return l.tag < r;
+                    });
+                    if (column == m_tag_columns.end() || column->tag != tag) {
+                        column = m_tag_columns.insert(column, TagColumn());
+                        column->tag = tag;
+                        column->tests.assign(GetNumberOfWords(), 0);
+                    }
+                    column->tests[index / 64] |= uint64_t(1) << (index % 64);
+
+                    tags += length;
+                } else {
+                    tags += 1;
+                }
+            }
+        }
+
+        m_is_tag_index_built = true;
+    }
+
+    std::vector<std::unique_ptr<TTK_TestData[]>>    m_chunks;
+    SizeType                                        m_number_of_tests;
+    std::vector<SizeType>                           m_sorted_by_name;   // indices of tests, empty if not built yet
+    std::vector<TagColumn>                          m_tag_columns;      // sorted by tag
+    bool                                            m_is_tag_index_built;
+};
+
+//------------------------------------------------------------------------------
+
+// Decodes single code point from utf-8 text, without use of locale. Invalid sequence is decoded as U+FFFD.
+// Returns number of consumed bytes (at least 1).
+inline size_t TTK_DecodeUTF8(const char* text, size_t length, uint32_t& code_point) {
+    const uint8_t lead = uint8_t(text[0]);
+
+    if (lead < 0x80) {
+        code_point = lead;
+        return 1;
+    }
+
+    const size_t number_of_tails = (lead >= 0xC2 && lead <= 0xDF) ? 1 : (lead >= 0xE0 && lead <= 0xEF) ? 2 : (lead >= 0xF0 && lead <= 0xF4) ? 3 : 0;
+    static const uint32_t s_min_code_points[] = {0, 0x80, 0x800, 0x10000};
+
+    uint32_t    value = lead & (0x3F >> number_of_tails);
+    size_t      count = 1;
+
+    while (count <= number_of_tails && count < length && (uint8_t(text[count]) & 0xC0) == 0x80) {
+        value = (value << 6) | (uint8_t(text[count]) & 0x3F);
+        ++count;
+    }
+
+    const bool is_valid = number_of_tails != 0 && count == number_of_tails + 1 
+        && value >= s_min_code_points[number_of_tails] && value <= 0x10FFFF && !(value >= 0xD800 && value <= 0xDFFF);
+
+    code_point = is_valid ? value : 0xFFFD;
+    return count;
+}
+
+// Writes utf-8 text to wide oriented file. Text is converted to utf-16 (or utf-32, when wchar_t has 4 bytes), without use of locale.
+// Conversion goes through fixed buffer on stack, so it can be used when process is terminated by signal.
+inline void TTK_WriteUTF8AsWide(FILE* file, const char* text, size_t length) {
+    enum { COUNT = 256 };
+    wchar_t buffer[COUNT + 3];
+    size_t  count = 0;
+
+    for (size_t index = 0; index < length;) {
+        uint32_t code_point = 0;
+        index += TTK_DecodeUTF8(text + index, length - index, code_point);
+
+        if (sizeof(wchar_t) == 2 && code_point >= 0x10000) {
+            code_point -= 0x10000;
+            buffer[count++] = wchar_t(0xD800 + (code_point >> 10));
+            buffer[count++] = wchar_t(0xDC00 + (code_point & 0x3FF));
+        } else {
+            buffer[count++] = wchar_t(code_point);
+        }
+
+        if (count >= COUNT) {
+            buffer[count] = L'\0';
+            fputws(buffer, file);
+            count = 0;
+        }
+    }
+
+    if (count > 0) {
+        buffer[count] = L'\0';
+        fputws(buffer, file);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Output for communicates generated by this library. Communicates are formatted as utf-8 text. 
+// For wide oriented output, they are converted to wide characters by this library, so global locale is never changed.
+// In buffered modes, gathered text is written when buffer is full, at fail, at end of TTK_Run, 
+// and when process is terminated by signal (best effort).
+class TTK_Output {
+public:
+    TTK_Output() {
+        m_file                  = stdout;
+        m_forced_orientation    = 0;
+        m_mode                  = TTK_OUTPUT_DIRECT;
+        m_buffer_size           = 1 << 16;
+
+        m_is_begun              = false;
+        m_is_writer_running     = false;
+        m_is_stop_request       = false;
+        m_is_writing            = false;
+
+        for (size_t index = 0; index < NUMBER_OF_HANDLED_SIGNALS; ++index) m_prev_signal_handlers[index] = SIG_DFL;
+    }
+
+    virtual ~TTK_Output() {
+        End();
+    }
+
+    void SetFile(FILE* file) {
+        Flush();
+        m_file = file;
+    }
+
+    FILE* GetFile() const {
+        return m_file;
+    }
+
+    void ForceOrientation(int orientation) {
+        m_forced_orientation = orientation;
+    }
+
+    int SolveOrientation() const {
+        if (m_forced_orientation != 0) return m_forced_orientation;
+        return fwide(m_file, 0);
+    }
+
+    void SetMode(TTK_OutputMode mode, size_t buffer_size) {
+        End();
+        m_mode          = mode;
+        m_buffer_size   = buffer_size ? buffer_size : 1;
+    }
+
+    // Starts gathering of communicates (for buffered modes). Called at beginning of TTK_Run.
+    void Begin() {
+        if (m_is_begun || m_mode == TTK_OUTPUT_DIRECT) return;
+        m_is_begun = true;
+
+        ToActiveOutput() = this;
+        for (size_t index = 0; index < NUMBER_OF_HANDLED_SIGNALS; ++index) {
+            m_prev_signal_handlers[index] = signal(GetHandledSignal(index), HandleSignal);
+        }
+
+        if (m_mode == TTK_OUTPUT_ASYNC) {
+            m_is_stop_request   = false;
+            m_writer            = std::thread(&TTK_Output::Write, this);
+            m_is_writer_running = true;
+        }
+    }
+
+    // Writes all gathered communicates. Called at end of TTK_Run.
+    void End() {
+        if (!m_is_begun) return;
+
+        Flush();
+
+        if (m_is_writer_running) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_is_stop_request = true;
+            }
+            m_condition.notify_all();
+            m_writer.join();
+            m_is_writer_running = false;
+        }
+
+        for (size_t index = 0; index < NUMBER_OF_HANDLED_SIGNALS; ++index) {
+            signal(GetHandledSignal(index), m_prev_signal_handlers[index]);
+        }
+        ToActiveOutput() = nullptr;
+
+        m_is_begun = false;
+    }
+
+    // Drops gathered communicates without writing them. 
+    // Used by child process, which received copy of parent's output, but not its writer thread.
+    // Child process can leave by exit() from test function, which destroys this output. So signal handlers are restored, 
+    // writer thread is detached, and mutex with condition variable (copied with state of parent's writer thread) are constructed anew.
+    void Abandon() {
+        if (m_is_begun) {
+            for (size_t index = 0; index < NUMBER_OF_HANDLED_SIGNALS; ++index) {
+                signal(GetHandledSignal(index), m_prev_signal_handlers[index]);
+            }
+        }
+        if (m_writer.joinable()) m_writer.detach();
+
+        new (&m_mutex) std::mutex();
+        new (&m_condition) std::condition_variable();
+
+        ToActiveOutput()    = nullptr;
+        m_is_begun          = false;
+        m_is_writer_running = false;
+
+        m_buffer.clear();
+        m_pending.clear();
+    }
+
+    // Formats utf-8 text. Format conversions for strings (%s) take utf-8 strings.
+    void Print(const char* format, ...) {
+        if (!m_file) return;
+
+        va_list arguments;
+        va_start(arguments, format);
+
+        if (m_is_begun) {
+            std::string text;
+            AppendFormatted(text, format, arguments);
+            Append(text);
+        } else if (SolveOrientation() > 0) {
+            std::string text;
+            AppendFormatted(text, format, arguments);
+            WriteToFile(text);
+        } else {
+            vfprintf(m_file, format, arguments);
+        }
+
+        va_end(arguments);
+    }
+
+    // Writes gathered communicates and flushes file.
+    void Flush() {
+        if (!m_file) return;
+
+        if (m_is_writer_running) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            MoveToPending();
+            m_condition.notify_all();
+            m_condition.wait(lock, [&]() { return m_pending.empty() && !m_is_writing; });
+        } else {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            WriteToFile(m_buffer);
+            m_buffer.clear();
+        }
+
+        fflush(m_file);
+    }
+
+    // Flushes file in direct mode only. In buffered modes, communicates stay gathered.
+    void FlushIfDirect() {
+        if (m_file && !m_is_begun) fflush(m_file);
+    }
+
+private:
+    enum { NUMBER_OF_HANDLED_SIGNALS = 4 };
+
+    static int GetHandledSignal(size_t index) {
+        static const int s_signals[NUMBER_OF_HANDLED_SIGNALS] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+        return s_signals[index];
+    }
+
+    static TTK_Output*& ToActiveOutput() {
+        static TTK_Output* s_active_output = nullptr;
+        return s_active_output;
+    }
+
+    // Writes whatever is gathered, then lets signal terminate process. 
+    // Gathered text is skipped, if mutex can't be taken, since it can be modified at the moment (by other thread, or by interrupted one), 
+    // and reading it could crash inside handler. Waiting for mutex could never end.
+    static void HandleSignal(int signal_number) {
+        TTK_Output* output = ToActiveOutput();
+        ToActiveOutput() = nullptr;
+
+        if (output && output->m_file) {
+            if (output->m_mutex.try_lock()) {
+                output->WriteToFile(output->m_pending);
+                output->WriteToFile(output->m_buffer);
+                output->m_mutex.unlock();
+            }
+            fflush(output->m_file);
+        }
+
+        signal(signal_number, SIG_DFL);
+        raise(signal_number);
+    }
+
+    static void AppendFormatted(std::string& text, const char* format, va_list arguments) {
+        va_list arguments_copy;
+        va_copy(arguments_copy, arguments);
+        const int count = vsnprintf(nullptr, 0, format, arguments_copy);
+        va_end(arguments_copy);
+
+        if (count > 0) {
+            const size_t offset = text.size();
+            text.resize(offset + size_t(count) + 1);
+            vsnprintf(&text[offset], size_t(count) + 1, format, arguments);
+            text.resize(offset + size_t(count));
+        }
+    }
+
+    // Gathered text is modified only with locked mutex, also without writer thread, so signal handler can tell when it's safe to read it.
+    void Append(const std::string& text) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_is_writer_running) {
+            m_buffer += text;
+            if (m_buffer.size() >= m_buffer_size) {
+                MoveToPending();
+                m_condition.notify_all();
+            }
+        } else {
+            m_buffer += text;
+            if (m_buffer.size() >= m_buffer_size) {
+                WriteToFile(m_buffer);
+                m_buffer.clear();
+            }
+        }
+    }
+
+    // Must be called with locked mutex.
+    void MoveToPending() {
+        m_pending += m_buffer;
+        m_buffer.clear();
+    }
+
+    void WriteToFile(const std::string& text) {
+        if (text.empty()) return;
+
+        if (SolveOrientation() > 0) {
+            TTK_WriteUTF8AsWide(m_file, text.data(), text.size());
+        } else {
+            fwrite(text.data(), 1, text.size(), m_file);
+        }
+    }
+
+    // Background writer for TTK_OUTPUT_ASYNC mode.
+    void Write() {
+        std::string text;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (;;) {
+            m_condition.wait(lock, [&]() { return m_is_stop_request || !m_pending.empty(); });
+
+            if (m_pending.empty()) break; // stop request
+
+            text.swap(m_pending);
+            m_is_writing = true;
+
+            lock.unlock();
+            WriteToFile(text);
+            fflush(m_file);
+            text.clear();
+            lock.lock();
+
+            m_is_writing = false;
+            m_condition.notify_all();
+        }
+    }
+
+    FILE*                   m_file;
+    int                     m_forced_orientation;
+    TTK_OutputMode          m_mode;
+    size_t                  m_buffer_size;
+
+    bool                    m_is_begun;
+
+    std::string             m_buffer;           // gathered text
+    std::string             m_pending;          // text handed to writer thread
+
+    std::thread             m_writer;
+    bool                    m_is_writer_running;
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+    bool                    m_is_stop_request;
+    bool                    m_is_writing;
+
+    using SignalHandlerFnP_T = void (*)(int);
+    SignalHandlerFnP_T      m_prev_signal_handlers[NUMBER_OF_HANDLED_SIGNALS];
+};
+
+//------------------------------------------------------------------------------
+
+// Writes utf-8 text as content of xml attribute or element. Characters which are not allowed in xml 1.0 are replaced by '?'.
+inline void TTK_WriteEscapedXML(FILE* file, const char* text) {
+    for (; *text; ++text) {
+        const char c = *text;
+        switch (c) {
+        case '&':   fputs("&amp;", file);   break;
+        case '<':   fputs("&lt;", file);    break;
+        case '>':   fputs("&gt;", file);    break;
+        case '"':   fputs("&quot;", file);  break;
+        case '\'':  fputs("&apos;", file);  break;
+        default:
+            fputc((uint8_t(c) < 0x20 && c != '\t' && c != '\n' && c != '\r') ? '?' : c, file);
+        }
+    }
+}
+
+// Writes utf-8 text as json string (with quotes).
+inline void TTK_WriteEscapedJSON(FILE* file, const char* text) {
+    fputc('"', file);
+    for (; *text; ++text) {
+        const char c = *text;
+        switch (c) {
+        case '"':   fputs("\\\"", file);    break;
+        case '\\':  fputs("\\\\", file);    break;
+        case '\n':  fputs("\\n", file);     break;
+        case '\r':  fputs("\\r", file);     break;
+        case '\t':  fputs("\\t", file);     break;
+        default:
+            if (uint8_t(c) < 0x20) {
+                fprintf(file, "\\u%04x", unsigned(uint8_t(c)));
+            } else {
+                fputc(c, file);
+            }
+        }
+    }
+    fputc('"', file);
+}
+
+// Writes JUnit XML report. Each test case is written as soon as its test function has finished, 
+// so only communicates of single test function are kept in memory.
+// Number of test cases and failures is not written in attributes of test suite, because they are not known 
+// when test suite begins (consumers of JUnit XML count test cases by themselves).
+// File is not closed by reporter.
+class TTK_JUnitReporter : public TTK_Reporter {
+public:
+    explicit TTK_JUnitReporter(FILE* file, const char* suite_name = "TrivialTestKit") {
+        m_file          = file;
+        m_suite_name    = suite_name;
+    }
+
+    virtual ~TTK_JUnitReporter() {}
+
+    void OnRunBegin(uint64_t) override {
+        fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n  <testsuite name=\"", m_file);
+        TTK_WriteEscapedXML(m_file, m_suite_name);
+        fputs("\">\n", m_file);
+    }
+
+    void OnTestBegin(const TTK_TestData&) override {
+        m_failures.clear();
+        m_first_failure.clear();
+        m_notes.clear();
+    }
+
+    void OnAssertFail(const TTK_CommunicateData& communicate) override {
+        std::string failure;
+
+        if (communicate.kind == TTK_COMMUNICATE_KIND_CRASH) {
+            failure = "crash:" + communicate.message;
+        } else if (communicate.kind == TTK_COMMUNICATE_KIND_TIMEOUT) {
+            failure = "timeout:" + communicate.message;
+        } else {
+            failure = std::string(communicate.file_name_utf8) + ":" + std::to_string(communicate.line) + ": " + communicate.condition;
+            if (communicate.is_message) failure += ": " + communicate.message;
+        }
+
+        if (m_first_failure.empty()) m_first_failure = failure;
+        m_failures += failure + "\n";
+    }
+
+    void OnNote(const std::string& text) override {
+        m_notes += text + "\n";
+    }
+
+    void OnTestEnd(const TTK_TestData& test_data, const TTK_TestResult& test_result) override {
+        fputs("    <testcase classname=\"", m_file);
+        TTK_WriteEscapedXML(m_file, m_suite_name);
+        fputs("\" name=\"", m_file);
+        TTK_WriteEscapedXML(m_file, test_data.name);
+        fprintf(m_file, "\" time=\"%.6f\"", test_result.duration / 1e9);
+
+        if (m_failures.empty() && m_notes.empty()) {
+            fputs("/>\n", m_file);
+        } else {
+            fputs(">\n", m_file);
+            if (!m_failures.empty()) {
+                fputs("      <failure message=\"", m_file);
+                TTK_WriteEscapedXML(m_file, m_first_failure.c_str());
+                fputs("\">", m_file);
+                TTK_WriteEscapedXML(m_file, m_failures.c_str());
+                fputs("</failure>\n", m_file);
+            }
+            if (!m_notes.empty()) {
+                fputs("      <system-out>", m_file);
+                TTK_WriteEscapedXML(m_file, m_notes.c_str());
+                fputs("</system-out>\n", m_file);
+            }
+            fputs("    </testcase>\n", m_file);
+        }
+
+        if (!m_failures.empty()) fflush(m_file);
+    }
+
+    void OnRunEnd(const TTK_RunSummary&) override {
+        fputs("  </testsuite>\n</testsuites>\n", m_file);
+        fflush(m_file);
+    }
+
+private:
+    FILE*           m_file;
+    const char*     m_suite_name;
+
+    std::string     m_failures;         // of current test function, one per line
+    std::string     m_first_failure;
+    std::string     m_notes;
+};
+
+// Writes each event as single line with json object, as soon as event is delivered.
+// File is not closed by reporter.
+class TTK_JSONLinesReporter : public TTK_Reporter {
+public:
+    explicit TTK_JSONLinesReporter(FILE* file) {
+        m_file      = file;
+        m_test_name = "";
+    }
+
+    virtual ~TTK_JSONLinesReporter() {}
+
+    void OnRunBegin(uint64_t number_of_tests) override {
+        fprintf(m_file, "{\"event\":\"run_begin\",\"tests\":%llu}\n", (unsigned long long)number_of_tests);
+    }
+
+    void OnTestBegin(const TTK_TestData& test_data) override {
+        m_test_name = test_data.name;
+
+        fputs("{\"event\":\"test_begin\",\"name\":", m_file);
+        TTK_WriteEscapedJSON(m_file, m_test_name);
+        fputs("}\n", m_file);
+    }
+
+    void OnAssertFail(const TTK_CommunicateData& communicate) override {
+        if (communicate.kind == TTK_COMMUNICATE_KIND_CRASH) {
+            fputs("{\"event\":\"crash\",\"name\":", m_file);
+            TTK_WriteEscapedJSON(m_file, m_test_name);
+            fputs(",\"reason\":", m_file);
+            TTK_WriteEscapedJSON(m_file, communicate.message.c_str());
+        } else if (communicate.kind == TTK_COMMUNICATE_KIND_TIMEOUT) {
+            fputs("{\"event\":\"timeout\",\"name\":", m_file);
+            TTK_WriteEscapedJSON(m_file, m_test_name);
+            fputs(",\"timeout\":", m_file);
+            TTK_WriteEscapedJSON(m_file, communicate.message.c_str());
+        } else {
+            fputs("{\"event\":\"assert_fail\",\"name\":", m_file);
+            TTK_WriteEscapedJSON(m_file, m_test_name);
+            fputs(",\"file\":", m_file);
+            TTK_WriteEscapedJSON(m_file, communicate.file_name_utf8);
+            fprintf(m_file, ",\"line\":%u,\"condition\":", communicate.line);
+            TTK_WriteEscapedJSON(m_file, communicate.condition);
+            if (communicate.is_message) {
+                fputs(",\"message\":", m_file);
+                TTK_WriteEscapedJSON(m_file, communicate.message.c_str());
+            }
+        }
+        fputs("}\n", m_file);
+        fflush(m_file);
+    }
+
+    void OnNote(const std::string& text) override {
+        fputs("{\"event\":\"note\",\"name\":", m_file);
+        TTK_WriteEscapedJSON(m_file, m_test_name);
+        fputs(",\"text\":", m_file);
+        TTK_WriteEscapedJSON(m_file, text.c_str());
+        fputs("}\n", m_file);
+    }
+
+    void OnTestEnd(const TTK_TestData& test_data, const TTK_TestResult& test_result) override {
+        fputs("{\"event\":\"test_end\",\"name\":", m_file);
+        TTK_WriteEscapedJSON(m_file, test_data.name);
+        fprintf(m_file, ",\"result\":\"%s\",\"executed_asserts\":%llu,\"failed_asserts\":%llu,\"duration_ns\":%llu}\n", 
+            test_result.number_of_failed_asserts ? "fail" : "success", 
+            (unsigned long long)test_result.number_of_executed_asserts, 
+            (unsigned long long)test_result.number_of_failed_asserts, 
+            (unsigned long long)test_result.duration);
+
+        m_test_name = "";
+    }
+
+    void OnRunEnd(const TTK_RunSummary& summary) override {
+        fprintf(m_file, "{\"event\":\"run_end\",\"result\":\"%s\",\"executed_asserts\":%llu,\"failed_asserts\":%llu,\"executed_tests\":%llu,\"failed_tests\":%llu,\"duration_ns\":%llu}\n", 
+            summary.is_success ? "success" : "fail", 
+            (unsigned long long)summary.number_of_executed_asserts, 
+            (unsigned long long)summary.number_of_failed_asserts, 
+            (unsigned long long)summary.number_of_executed_tests, 
+            (unsigned long long)summary.number_of_failed_tests, 
+            (unsigned long long)summary.total_time);
+        fflush(m_file);
+    }
+
+private:
+    FILE*           m_file;
+    const char*     m_test_name;        // of currently reported test function
+};
+
+//------------------------------------------------------------------------------
+
+// Returns value of environment variable or empty string, if variable doesn't exist.
+inline std::string TTK_GetEnvironmentVariable(const char* name) {
+    std::string value;
+#if defined(_MSC_VER)
+    char*   buffer  = nullptr;
+    size_t  size    = 0;
+    if (_dupenv_s(&buffer, &size, name) == 0 && buffer) {
+        value = buffer;
+        free(buffer);
+    }
+#else
+    const char* buffer = getenv(name);
+    if (buffer) value = buffer;
+#endif
+    return value;
+}
+
+// Returns hash of test function name. The same on every platform and in every run.
+inline uint64_t TTK_HashName(const char* name) {
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (; *name; ++name) {
+        hash ^= uint8_t(*name);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+
+// Returns true, if whole text matches glob pattern ('*' - any sequence of characters, '?' - any single character).
+inline bool TTK_MatchGlob(const char* pattern, const char* text) {
+    const char* star_pattern    = nullptr;  // position after last '*'
+    const char* star_text       = nullptr;  // position in text, from which last '*' matches
+
+    while (*text) {
+        if (*pattern == '*') {
+            star_pattern    = ++pattern;
+            star_text       = text;
+        } else if (*pattern == '?' || *pattern == *text) {
+            ++pattern;
+            ++text;
+        } else if (star_pattern) {
+            pattern = star_pattern;
+            text    = ++star_text;
+        } else {
+            return false;
+        }
+    }
+
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+}
+
+// Filter of test functions by name (see TTK_AddFilter).
+class TTK_NameFilter {
+public:
+    TTK_NameFilter(const std::string& pattern, bool is_exclude, bool is_regex) {
+        m_pattern       = pattern;
+        m_is_exclude    = is_exclude;
+        m_is_regex      = is_regex;
+        m_is_valid      = true;
+
+        if (is_regex) {
+            try {
+                m_regex = std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+            } catch (const std::regex_error&) {
+                m_is_valid = false;
+            }
+            m_prefix = FindRegexPrefix(pattern);
+        } else {
+            m_prefix = pattern.substr(0, pattern.find_first_of("*?"));
+        }
+    }
+
+    virtual ~TTK_NameFilter() {}
+
+    bool IsValid() const {
+        return m_is_valid;
+    }
+
+    bool IsExclude() const {
+        return m_is_exclude;
+    }
+
+    // Returns text, which each matching name starts with.
+    const std::string& GetPrefix() const {
+        return m_prefix;
+    }
+
+    bool IsMatch(const char* name) const {
+        if (!m_is_valid) return false;
+        return m_is_regex ? std::regex_match(name, m_regex) : TTK_MatchGlob(m_pattern.c_str(), name);
+    }
+
+    // Parses filters in form "Include1:Include2-Exclude1:Exclude2".
+    static std::vector<TTK_NameFilter> Parse(const std::string& text) {
+        std::vector<TTK_NameFilter> filters;
+
+        bool    is_exclude  = false;
+        size_t  begin       = 0;
+
+        while (begin <= text.size()) {
+            const size_t end = std::min(text.find_first_of(is_exclude ? ":" : ":-", begin), text.size());
+
+            if (end > begin) filters.push_back(TTK_NameFilter(text.substr(begin, end - begin), is_exclude, false));
+            if (end < text.size() && text[end] == '-') is_exclude = true;
+
+            begin = end + 1;
+        }
+
+        return filters;
+    }
+
+private:
+    // Returns literal text at the beginning of regular expression, which each match must start with.
+    // Returns empty text, if regular expression has alternative on top level or starts with special character.
+    static std::string FindRegexPrefix(const std::string& pattern) {
+        if (pattern.find('|') != std::string::npos) return "";
+
+        const size_t length = pattern.find_first_of("\\^$.|?*+()[]{}");
+        if (length == std::string::npos) return pattern;
+
+        // quantifier makes preceding character optional or repeated
+        const char next = pattern[length];
+        if (length > 0 && (next == '?' || next == '*' || next == '{')) return pattern.substr(0, length - 1);
+
+        return pattern.substr(0, length);
+    }
+
+    std::string m_pattern;
+    std::string m_prefix;
+    bool        m_is_exclude;
+    bool        m_is_regex;
+    bool        m_is_valid;
+    std::regex  m_regex;
+};
+
+// Filter of test functions by expression of tags (see TTK_SetTagFilter). 
+// Expression is compiled to postfix program, which is evaluated on sets of test functions (bitsets), word by word.
+class TTK_TagFilter {
+public:
+    explicit TTK_TagFilter(const std::string& expression) {
+        m_expression    = expression;
+        m_position      = 0;
+        m_is_valid      = ParseOr();
+
+        SkipSpaces();
+        m_is_valid = m_is_valid && m_position == m_expression.size();
+    }
+
+    virtual ~TTK_TagFilter() {}
+
+    bool IsValid() const {
+        return m_is_valid;
+    }
+
+    const std::string& GetExpression() const {
+        return m_expression;
+    }
+
+    // Returns set of tests which satisfy expression. Test of index has bit (index % 64) in word (index / 64).
+    std::vector<uint64_t> Select(TTK_Register& tests) const {
+        const size_t number_of_words = tests.GetNumberOfWords();
+
+        // Mask of bits of existing tests in last word.
+        const uint64_t last_word_mask = (tests.GetNumberOfTests() % 64) ? (uint64_t(1) << (tests.GetNumberOfTests() % 64)) - 1 : ~uint64_t(0);
+
+        std::vector<std::vector<uint64_t>> stack;
+        stack.reserve(m_program.size());
+
+        for (const Instruction& instruction : m_program) {
+            switch (instruction.operation) {
+            case OPERATION_TAG: {
+                const std::vector<uint64_t>* tagged = tests.FindTestsByTag(instruction.tag);
+                stack.push_back(tagged ? *tagged : std::vector<uint64_t>(number_of_words, 0));
+                break;
+            }
+            case OPERATION_NOT: {
+                std::vector<uint64_t>& words = stack.back();
+                for (uint64_t& word : words) word = ~word;
+                if (number_of_words) words.back() &= last_word_mask;
+                break;
+            }
+            case OPERATION_AND:
+            case OPERATION_OR: {
+                std::vector<uint64_t> right = std::move(stack.back());
+                stack.pop_back();
+                std::vector<uint64_t>& left = stack.back();
+
+                if (instruction.operation == OPERATION_AND) {
+                    for (size_t index = 0; index < number_of_words; ++index) left[index] &= right[index];
+                } else {
+                    for (size_t index = 0; index < number_of_words; ++index) left[index] |= right[index];
+                }
+                break;
+            }
+            }
+        }
+
+        return stack.empty() ? std::vector<uint64_t>(number_of_words, 0) : std::move(stack.back());
+    }
+
+private:
+    enum Operation {
+        OPERATION_TAG,
+        OPERATION_NOT,
+        OPERATION_AND,
+        OPERATION_OR,
+    };
+
+    struct Instruction {
+        Operation   operation;
+        std::string tag;
+    };
+
+    static bool IsTagCharacter(char character) {
+        return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9') || 
+            character == '_' || character == '-' || character == '.';
+    }
+
+    void SkipSpaces() {
+        while (m_position < m_expression.size() && (m_expression[m_position] == ' ' || m_expression[m_position] == '\t')) ++m_position;
+    }
+
+    // Takes operator given as symbol or as word. Word must not be followed by character of tag.
+    bool TakeOperator(char symbol, const char* word) {
+        SkipSpaces();
+        if (m_position < m_expression.size() && m_expression[m_position] == symbol) {
+            m_position += 1;
+            return true;
+        }
+
+        const size_t length = strlen(word);
+        if (m_expression.compare(m_position, length, word) == 0 && 
+                (m_position + length == m_expression.size() || !IsTagCharacter(m_expression[m_position + length]))) {
+            m_position += length;
+            return true;
+        }
+        return false;
+    }
+
+    // or-expression:   and-expression { ('or' | '|') and-expression }
+    bool ParseOr() {
+        if (!ParseAnd()) return false;
+        while (TakeOperator('|', "or")) {
+            if (!ParseAnd()) return false;
+            m_program.push_back({OPERATION_OR, ""});
+        }
+        return true;
+    }
+
+    // and-expression:  unary-expression { ('and' | '&') unary-expression }
+    bool ParseAnd() {
+        if (!ParseUnary()) return false;
+        while (TakeOperator('&', "and")) {
+            if (!ParseUnary()) return false;
+            m_program.push_back({OPERATION_AND, ""});
+        }
+        return true;
+    }
+
+    // unary-expression: ('not' | '!') unary-expression | '(' or-expression ')' | tag
+    bool ParseUnary() {
+        if (TakeOperator('!', "not")) {
+            if (!ParseUnary()) return false;
+            m_program.push_back({OPERATION_NOT, ""});
+            return true;
+        }
+
+        SkipSpaces();
+        if (m_position < m_expression.size() && m_expression[m_position] == '(') {
+            m_position += 1;
+            if (!ParseOr()) return false;
+
+            SkipSpaces();
+            if (m_position >= m_expression.size() || m_expression[m_position] != ')') return false;
+            m_position += 1;
+            return true;
+        }
+
+        const size_t begin = m_position;
+        while (m_position < m_expression.size() && IsTagCharacter(m_expression[m_position])) ++m_position;
+        if (m_position == begin) return false;
+
+        m_program.push_back({OPERATION_TAG, m_expression.substr(begin, m_position - begin)});
+        return true;
+    }
+
+    std::string                 m_expression;
+    size_t                      m_position;         // of parsing
+    std::vector<Instruction>    m_program;          // postfix
+    bool                        m_is_valid;
+};
+
+//------------------------------------------------------------------------------
+
+#if defined(_MSC_VER)      
+#define TTK_TRY_FORCE_NON_INLINE __declspec(noinline)
+#elif defined(__GNUC__) 
+#define TTK_TRY_FORCE_NON_INLINE __attribute__((noinline))
+#else
+#define TTK_TRY_FORCE_NON_INLINE
+#endif
+
+// Marks function as rarely called, so it's placed away from hot code and its callers are optimized for not calling it.
+#if defined(__GNUC__) 
+#define TTK_COLD __attribute__((cold))
+#else
+#define TTK_COLD
+#endif
+
+// Hints compiler that condition is rarely true.
+#if defined(__GNUC__) 
+#define TTK_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define TTK_UNLIKELY(condition) (condition)
+#endif
+
+//------------------------------------------------------------------------------
+
+// Opens file. Path is in utf-8, also on Windows.
+inline FILE* TTK_OpenFile(const char* file_name_utf8, const char* mode) {
+#if defined(_WIN32)
+    const size_t length = strlen(file_name_utf8);
+
+    std::wstring file_name;
+    for (size_t index = 0; index < length;) {
+        uint32_t code_point = 0;
+        index += TTK_DecodeUTF8(file_name_utf8 + index, length - index, code_point);
+
+        if (code_point >= 0x10000) {
+            code_point -= 0x10000;
+            file_name += wchar_t(0xD800 + (code_point >> 10));
+            file_name += wchar_t(0xDC00 + (code_point & 0x3FF));
+        } else {
+            file_name += wchar_t(code_point);
+        }
+    }
+
+    const std::wstring mode_wide(mode, mode + strlen(mode));
+
+    FILE* file = nullptr;
+    return (_wfopen_s(&file, file_name.c_str(), mode_wide.c_str()) == 0) ? file : nullptr;
+#else
+    return fopen(file_name_utf8, mode);
+#endif
+}
+
+// Baseline times of TTK_ASSERT_NOT_SLOWER. Can be accessed by many workers at once.
+class TTK_BaselineStore {
+public:
+    TTK_BaselineStore() {
+        m_is_modified = false;
+    }
+
+    virtual ~TTK_BaselineStore() {}
+
+    // Loads baselines from text file, one per line: <time in nanoseconds> <key>. 
+    // Not existing file is loaded as empty. Returns false, if file can not be read.
+    bool Load(const std::string& file_name_utf8) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_baselines.clear();
+        m_is_modified = false;
+
+        FILE* file = TTK_OpenFile(file_name_utf8.c_str(), "rb");
+        if (!file) return errno == ENOENT;
+
+        std::string content;
+        char buffer[4096];
+        for (size_t count; (count = fread(buffer, 1, sizeof(buffer), file)) > 0;) content.append(buffer, count);
+
+        const bool is_error = ferror(file) != 0;
+        fclose(file);
+        if (is_error) return false;
+
+        for (size_t begin = 0; begin < content.size();) {
+            size_t end = content.find('\n', begin);
+            if (end == std::string::npos) end = content.size();
+
+            std::string line = content.substr(begin, end - begin);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+
+            const size_t separator = line.find(' ');
+            if (separator != std::string::npos) {
+                m_baselines.push_back({line.substr(separator + 1), strtod(line.substr(0, separator).c_str(), nullptr)});
+            }
+
+            begin = end + 1;
+        }
+
+        std::stable_sort(m_baselines.begin(), m_baselines.end(), IsKeyLess);
+        return true;
+    }
+
+    // Saves baselines to text file, sorted by key. Returns false, if file can not be written.
+    bool Save(const std::string& file_name_utf8) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        FILE* file = TTK_OpenFile(file_name_utf8.c_str(), "wb");
+        if (!file) return false;
+
+        for (const std::pair<std::string, double>& baseline : m_baselines) {
+            fprintf(file, "%.3f %s\n", baseline.second, baseline.first.c_str());
+        }
+
+        const bool is_error = ferror(file) != 0;
+        if (fclose(file) != 0 || is_error) return false;
+
+        m_is_modified = false;
+        return true;
+    }
+
+    // Returns false, if there is no baseline for key.
+    bool Find(const std::string& key, double& time) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::vector<std::pair<std::string, double>>::const_iterator it = std::lower_bound(m_baselines.begin(), m_baselines.end(), std::make_pair(key, 0.0), IsKeyLess);
+        if (it == m_baselines.end() || it->first != key) return false;
+
+        time = it->second;
+        return true;
+    }
+
+    // Sets baseline for key. time is in nanoseconds.
+    void Set(const std::string& key, double time) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::vector<std::pair<std::string, double>>::iterator it = std::lower_bound(m_baselines.begin(), m_baselines.end(), std::make_pair(key, 0.0), IsKeyLess);
+        if (it != m_baselines.end() && it->first == key) {
+            it->second = time;
+        } else {
+            m_baselines.insert(it, {key, time});
+        }
+        m_is_modified = true;
+    }
+
+    bool IsModified() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_is_modified;
+    }
+
+private:
+    static bool IsKeyLess(const std::pair<std::string, double>& l, const std::pair<std::string, double>& r) {
+        return l.first < r.first;
+    }
+
+    std::vector<std::pair<std::string, double>> m_baselines;   // sorted by key
+    bool                                        m_is_modified;
+    mutable std::mutex                          m_mutex;
+};
+
+// Returns identity of executable of current process, which changes when binary is rebuilt (size and modification time), 
+// or "unknown" if it can not be taken.
+inline std::string TTK_GetBinaryIdentity() {
+    unsigned long long size = 0;
+    unsigned long long time = 0;
+
+#if defined(_WIN32)
+    wchar_t                     file_name[MAX_PATH + 1] = {};
+    WIN32_FILE_ATTRIBUTE_DATA   attributes              = {};
+
+    const DWORD length = GetModuleFileNameW(nullptr, file_name, MAX_PATH + 1);
+    if (length == 0 || length > MAX_PATH || !GetFileAttributesExW(file_name, GetFileExInfoStandard, &attributes)) return "unknown";
+
+    size = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    time = ((unsigned long long)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat status = {};
+    if (stat("/proc/self/exe", &status) != 0) return "unknown";
+
+    size = (unsigned long long)status.st_size;
+#if defined(__linux__)
+    time = (unsigned long long)status.st_mtim.tv_sec * 1000000000ull + (unsigned long long)status.st_mtim.tv_nsec;
+#else
+    time = (unsigned long long)status.st_mtime;
+#endif
+#endif
+
+    char identity[64] = {};
+    snprintf(identity, sizeof(identity), "%llx-%llx", size, time);
+    return identity;
+}
+
+struct TTK_CachedResult {
+    std::string     name;
+    bool            is_fail;
+    uint64_t        duration;           // in nanoseconds
+    std::string     binary_identity;    // see TTK_GetBinaryIdentity
+};
+
+// Results of test functions from previous runs (see TTK_SetResultCache).
+class TTK_ResultCache {
+public:
+    TTK_ResultCache() {}
+    virtual ~TTK_ResultCache() {}
+
+    // Loads results from file. First line is header, then there is one result per line: <P|F> <duration in nanoseconds> <binary identity> <name>. 
+    // Not existing file is loaded as empty. Returns false, if file can not be read or has unknown format.
+    bool Load(const std::string& file_name_utf8) {
+        m_results.clear();
+
+        FILE* file = TTK_OpenFile(file_name_utf8.c_str(), "rb");
+        if (!file) return errno == ENOENT;
+
+        std::string content;
+        char buffer[4096];
+        for (size_t count; (count = fread(buffer, 1, sizeof(buffer), file)) > 0;) content.append(buffer, count);
+
+        const bool is_error = ferror(file) != 0;
+        fclose(file);
+        if (is_error || content.compare(0, strlen(GetHeader()), GetHeader()) != 0) return false;
+
+        for (size_t begin = strlen(GetHeader()); begin < content.size();) {
+            size_t end = content.find('\n', begin);
+            if (end == std::string::npos) end = content.size();
+
+            const std::string line = content.substr(begin, end - begin);
+
+            const size_t duration_end = line.find(' ', 2);
+            const size_t identity_end = (duration_end != std::string::npos) ? line.find(' ', duration_end + 1) : std::string::npos;
+
+            if (line.size() > 2 && (line[0] == 'P' || line[0] == 'F') && line[1] == ' ' && identity_end != std::string::npos) {
+                m_results.push_back({
+                    line.substr(identity_end + 1),
+                    line[0] == 'F',
+                    uint64_t(strtoull(line.substr(2, duration_end - 2).c_str(), nullptr, 10)),
+                    line.substr(duration_end + 1, identity_end - duration_end - 1)
+                });
+            }
+
+            begin = end + 1;
+        }
+
+        std::stable_sort(m_results.begin(), m_results.end(), IsNameLess);
+        return true;
+    }
+
+    // Saves results to file, sorted by name. Returns false, if file can not be written.
+    bool Save(const std::string& file_name_utf8) const {
+        FILE* file = TTK_OpenFile(file_name_utf8.c_str(), "wb");
+        if (!file) return false;
+
+        fputs(GetHeader(), file);
+        for (const TTK_CachedResult& result : m_results) {
+            fprintf(file, "%c %llu %s %s\n", result.is_fail ? 'F' : 'P', (unsigned long long)result.duration, result.binary_identity.c_str(), result.name.c_str());
+        }
+
+        const bool is_error = ferror(file) != 0;
+        return fclose(file) == 0 && !is_error;
+    }
+
+    // Replaces cached results of executed test functions.
+    void Update(const std::vector<TTK_TestRecord>& records, const std::string& binary_identity) {
+        for (const TTK_TestRecord& record : records) {
+            const TTK_CachedResult result = {record.name, record.is_fail, record.duration, binary_identity};
+
+            const std::vector<TTK_CachedResult>::iterator it = std::lower_bound(m_results.begin(), m_results.end(), result, IsNameLess);
+            if (it != m_results.end() && it->name == result.name) {
+                *it = result;
+            } else {
+                m_results.insert(it, result);
+            }
+        }
+    }
+
+    // Returns nullptr, if there is no result of test function.
+    const TTK_CachedResult* Find(const char* name) const {
+        const std::vector<TTK_CachedResult>::const_iterator it = std::lower_bound(m_results.begin(), m_results.end(), name, [](const TTK_CachedResult& result, const char* name) {
+            return result.name < name;
+        });
+        return (it != m_results.end() && it->name == name) ? &(*it) : nullptr;
+    }
+
+    // Returns results sorted by name.
+    const std::vector<TTK_CachedResult>& GetResults() const {
+        return m_results;
+    }
+
+private:
+    static const char* GetHeader() {
+        return "TTK_RESULT_CACHE 1\n";
+    }
+
+    static bool IsNameLess(const TTK_CachedResult& l, const TTK_CachedResult& r) {
+        return l.name < r.name;
+    }
+
+    std::vector<TTK_CachedResult> m_results;   // sorted by name
+};
+
+//------------------------------------------------------------------------------
+
+class TTK_Suite {
+public:
+    TTK_Suite() {
+        m_number_of_executed_asserts    = 0;
+        m_number_of_failed_asserts      = 0;
+
+        m_number_of_executed_tests      = 0;
+        m_number_of_failed_tests        = 0;
+
+        m_number_of_workers             = 1;
+
+        m_is_process_isolation          = false;
+        m_report_descriptor             = -1;
+
+        m_is_print_test_time            = false;
+        m_number_of_slowest_tests       = 0;
+        m_total_time                    = 0;
+
+        m_benchmark_min_sample_time     = 10000000;
+        m_benchmark_number_of_samples   = 10;
+
+        m_property_number_of_cases      = 1000;
+        m_property_max_time             = 0;
+        m_property_seed                 = 0;
+        m_property_run_seed             = 0;
+
+        m_shard_index                   = 0;
+        m_number_of_shards              = 0;
+        m_is_shard_set                  = false;
+
+        m_is_max_test_num_reached       = false;
+        m_is_static_tests_collected     = false;
+
+        m_test_timeout                  = 0;
+        m_run_timeout                   = 0;
+        m_run_begin_time                = 0;
+
+        m_max_failed_tests              = 0;
+        m_max_failed_asserts            = 0;
+        m_number_of_live_failed_tests   = 0;
+        m_number_of_live_failed_asserts = 0;
+        m_is_cancelled                  = false;
+        m_is_deferred_stopped           = false;
+
+        m_is_print_allocations          = false;
+
+        m_baseline_file_name            = "TTK_Baselines.txt";
+        m_is_baselines_loaded           = false;
+        m_baseline_mode                 = TTK_BASELINE_CHECK;
+        m_baseline_run_mode             = TTK_BASELINE_CHECK;
+
+        m_result_cache_mode             = TTK_CACHE_RUN_ALL;
+        m_result_cache_run_mode         = TTK_CACHE_RUN_ALL;
+        m_is_longest_first              = false;
+
+        m_stray_test_result             = {};
+    }
+
+    virtual ~TTK_Suite() {
+        m_output.End();
+        if (m_output.GetFile()) fclose(m_output.GetFile());
+    }
+
+    void AddTest(const TTK_TestData& test_data) {
+        if (!m_tests.AddTest(test_data)) {
+            m_is_max_test_num_reached = true;
+        }
+    }
+
+    void ReserveTests(size_t number_of_tests) {
+        m_tests.Reserve(number_of_tests);
+    }
+
+    template <typename Type, typename ContainerType>
+    void AddTestValues(void (*function)(const Type&), const char* name, const ContainerType& values, uint64_t mode) {
+        std::vector<Type> case_values(std::begin(values), std::end(values));
+        const uint64_t number_of_cases = case_values.size();
+
+        AddTestCases(new TTK_ValueCaseSet<Type>(function, std::move(case_values)), TTK_ValueCaseSet<Type>::Execute, name, number_of_cases, mode);
+    }
+
+    template <typename Type>
+    void AddTestRange(void (*function)(const Type&), const char* name, const typename TTK_NonDeduced<Type>::Type_T& begin, const typename TTK_NonDeduced<Type>::Type_T& end, const typename TTK_NonDeduced<Type>::Type_T& step, uint64_t mode) {
+        uint64_t number_of_cases = 0;
+        if (step > Type(0)) {
+            while (Type(begin + Type(number_of_cases) * step) < end) ++number_of_cases;
+        }
+
+        AddTestCases(new TTK_RangeCaseSet<Type>(function, begin, step), TTK_RangeCaseSet<Type>::Execute, name, number_of_cases, mode);
+    }
+
+    template <typename Type>
+    void AddTestGenerator(void (*function)(const Type&), const char* name, typename TTK_NonDeduced<Type (*)(uint64_t)>::Type_T generator, uint64_t number_of_cases, uint64_t mode) {
+        AddTestCases(new TTK_GeneratorCaseSet<Type>(function, generator), TTK_GeneratorCaseSet<Type>::Execute, name, number_of_cases, mode);
+    }
+
+    void Clear() {
+        m_tests.Clear();
+        m_test_records.clear();
+        m_total_time = 0;
+        m_is_max_test_num_reached = false;
+        m_is_static_tests_collected = true; // they are removed as well
+        m_reporters.clear();
+        m_case_sets.clear();
+    }
+
+    void AddReporter(TTK_Reporter* reporter) {
+        if (reporter) m_reporters.push_back(reporter);
+    }
+
+    TTK_TRY_FORCE_NON_INLINE
+    void CommunicateAssertFail(unsigned line, const char* condition, const char* file_name_utf8, const char* message) {
+        TTK_TestResult& test_result = ToCurrentTestResult();
+
+        if (m_report_descriptor < 0 && test_result.is_deferred) {
+            std::lock_guard<std::mutex> lock(m_deferred_mutex);
+            if (m_is_deferred_stopped) return;
+
+            test_result.number_of_failed_asserts += 1;
+            CountFailedAsserts(1);
+            test_result.communicates.push_back({TTK_COMMUNICATE_KIND_ASSERT_FAIL, line, condition, file_name_utf8, message ? message : "", message != nullptr});
+            return;
+        }
+
+        test_result.number_of_failed_asserts += 1;
+        CountFailedAsserts(1);
+
+        if (m_report_descriptor >= 0) {
+            ReportAssertFail(test_result, line, condition, file_name_utf8, message);
+        } else {
+            PrintAssertFail(line, condition, file_name_utf8, message);
+            if (!m_reporters.empty()) NotifyCommunicate({TTK_COMMUNICATE_KIND_ASSERT_FAIL, line, condition, file_name_utf8, message ? message : "", message != nullptr});
+        }
+    }
+
+    void CommunicateAssertFail(unsigned line, const char* condition, const char* file_name_utf8, const std::string& message) {
+        CommunicateAssertFail(line, condition, file_name_utf8, message.c_str());
+    }
+
+    // Displays additional information about currently executed test function, below its fails.
+    void CommunicateNote(const std::string& text) {
+        TTK_TestResult& test_result = ToCurrentTestResult();
+
+        if (m_report_descriptor >= 0) {
+            ReportNote(text);
+        } else if (test_result.is_deferred) {
+            std::lock_guard<std::mutex> lock(m_deferred_mutex);
+            if (!m_is_deferred_stopped) test_result.communicates.push_back({TTK_COMMUNICATE_KIND_NOTE, 0, nullptr, nullptr, text, true});
+        } else {
+            PrintNote(text.c_str());
+            if (!m_reporters.empty()) NotifyCommunicate({TTK_COMMUNICATE_KIND_NOTE, 0, nullptr, nullptr, text, true});
+        }
+    }
+
+    void SetBenchmarkConfig(uint64_t min_sample_time, uint32_t number_of_samples) {
+        m_benchmark_min_sample_time     = min_sample_time;
+        m_benchmark_number_of_samples   = number_of_samples ? number_of_samples : 1;
+    }
+
+    uint64_t GetBenchmarkMinSampleTime() const {
+        return m_benchmark_min_sample_time;
+    }
+
+    uint32_t GetBenchmarkNumberOfSamples() const {
+        return m_benchmark_number_of_samples;
+    }
+
+    void SetPropertyConfig(uint64_t number_of_cases, uint64_t max_time, uint64_t seed) {
+        m_property_number_of_cases  = (number_of_cases || max_time) ? number_of_cases : 1000;
+        m_property_max_time         = max_time;
+        m_property_seed             = seed;
+    }
+
+    uint64_t GetPropertyNumberOfCases() const {
+        return m_property_number_of_cases;
+    }
+
+    uint64_t GetPropertyMaxTime() const {
+        return m_property_max_time;
+    }
+
+    // Returns seed of properties for current TTK_Run.
+    uint64_t GetPropertySeed() const {
+        return m_property_run_seed;
+    }
+
+    void SetBaseline(const char* file_name_utf8, TTK_BaselineMode mode) {
+        m_baseline_file_name    = file_name_utf8 ? file_name_utf8 : "TTK_Baselines.txt";
+        m_baseline_mode         = mode;
+    }
+
+    void SetResultCache(const char* file_name_utf8, TTK_ResultCacheMode mode) {
+        m_result_cache_file_name    = file_name_utf8 ? file_name_utf8 : "";
+        m_result_cache_mode         = mode;
+    }
+
+    void SetLongestFirst(bool is_longest_first) {
+        m_is_longest_first = is_longest_first;
+    }
+
+    // Registers fixture, which has constructed its first object, to be destroyed at the end of run. Can be called by many workers at once.
+    void AddConstructedFixture(TTK_FixtureBase* fixture) {
+        std::lock_guard<std::mutex> lock(m_fixture_mutex);
+        m_constructed_fixtures.push_back(fixture);
+    }
+
+    // Returns mode of baselines for current TTK_Run.
+    TTK_BaselineMode GetBaselineMode() const {
+        return m_baseline_run_mode;
+    }
+
+    bool FindBaseline(const std::string& key, double& time) {
+        LoadBaselines();
+        return m_baselines.Find(key, time);
+    }
+
+    // Records baseline. In child process, baseline is sent to parent process, which records it.
+    void RecordBaseline(const std::string& key, double time) {
+        if (m_report_descriptor >= 0) {
+            ReportBaseline(key, time);
+        } else {
+            LoadBaselines();
+            m_baselines.Set(key, time);
+        }
+    }
+
+    bool Run() {
+        bool is_success = false;
+
+        if (!m_is_static_tests_collected) {
+            const std::pair<const TTK_StaticTest* const*, const TTK_StaticTest* const*> static_tests = TTK_GetStaticTests();
+            m_tests.AddStaticTests(static_tests.first, static_tests.second);
+            m_is_static_tests_collected = true;
+        }
+
+        m_property_run_seed = SolvePropertySeed();
+        m_baseline_run_mode = SolveBaselineMode();
+
+        m_is_baselines_loaded = false;
+
+        m_output.Begin();
+
+        m_result_cache_run_mode = SolveResultCacheMode();
+        if (!m_result_cache_file_name.empty()) {
+            if (m_binary_identity.empty()) m_binary_identity = TTK_GetBinaryIdentity();
+
+            if (!m_result_cache.Load(m_result_cache_file_name)) {
+                m_output.Print("TTK Error: Can not load result cache from file: %s\n", m_result_cache_file_name.c_str());
+            }
+        }
+
+        if (m_is_max_test_num_reached) {
+            m_output.Print("TTK Error: Max number of test (%llu) has been reached.", (uint64_t)m_tests.GetMaxNumberOfTests());
+        } else {
+            m_number_of_executed_asserts = 0;
+            m_number_of_failed_asserts   = 0;
+
+            m_number_of_executed_tests   = 0;
+            m_number_of_failed_tests     = 0;
+
+            m_test_records.clear();
+
+            m_number_of_live_failed_tests   = 0;
+            m_number_of_live_failed_asserts = 0;
+            m_is_cancelled                  = false;
+
+            m_output.Print("%s", "--- TEST ---\n");
+
+            const std::vector<TTK_Register::SizeType> indices = SelectTests();
+            const uint32_t number_of_workers = SolveNumberOfWorkers();
+            m_run_begin_time = TTK_GetTime();
+
+            for (TTK_Reporter* reporter : m_reporters) reporter->OnRunBegin(indices.size());
+
+            if (m_is_process_isolation && IsProcessIsolationAvailable()) {
+                RunInChildProcesses(indices, number_of_workers);
+            } else if (number_of_workers > 1 && indices.size() > 1) {
+                RunOnWorkers(indices, number_of_workers);
+            } else {
+                RunOnCurrentThread(indices);
+            }
+
+            if (m_is_cancelled) PrintCancel(indices.size());
+
+            DestroyFixtures();
+
+            if (m_is_baselines_loaded && m_baselines.IsModified() && !m_baselines.Save(m_baseline_file_name)) {
+                m_output.Print("TTK Error: Can not save baselines to file: %s\n", m_baseline_file_name.c_str());
+            }
+            SaveResultCache();
+
+            is_success = EndRun();
+        }
+
+        m_output.End();
+
+        return is_success;
+    }
+
+
+    void SetOutput(FILE* output) {
+        m_output.SetFile(output);
+    }
+
+    void SetOutputMode(TTK_OutputMode mode, size_t buffer_size) {
+        m_output.SetMode(mode, buffer_size);
+    }
+
+    void ForceOutputOrientation(int orientation) {
+        m_output.ForceOrientation(orientation);
+    }
+
+    void SetNumberOfWorkers(uint32_t number_of_workers) {
+        m_number_of_workers = number_of_workers;
+    }
+
+    void SetProcessIsolation(bool is_process_isolation) {
+        m_is_process_isolation = is_process_isolation;
+    }
+
+    bool AddFilter(const char* pattern, bool is_exclude, bool is_regex) {
+        TTK_NameFilter filter(pattern ? pattern : "", is_exclude, is_regex);
+        if (!filter.IsValid()) return false;
+
+        m_filters.push_back(filter);
+        return true;
+    }
+
+    void ClearFilters() {
+        m_filters.clear();
+    }
+
+    bool SetTagFilter(const char* expression) {
+        if (!expression || !*expression) {
+            m_tag_filter.reset();
+            return true;
+        }
+
+        std::unique_ptr<TTK_TagFilter> tag_filter(new TTK_TagFilter(expression));
+        if (!tag_filter->IsValid()) return false;
+
+        m_tag_filter = std::move(tag_filter);
+        return true;
+    }
+
+    void SetShard(uint32_t shard_index, uint32_t number_of_shards) {
+        m_shard_index       = shard_index;
+        m_number_of_shards  = number_of_shards;
+        m_is_shard_set      = true;
+    }
+
+    void SetTimeReport(bool is_print_test_time, uint32_t number_of_slowest_tests) {
+        m_is_print_test_time        = is_print_test_time;
+        m_number_of_slowest_tests   = number_of_slowest_tests;
+    }
+
+    const std::vector<TTK_TestRecord>& GetTestRecords() const {
+        return m_test_records;
+    }
+
+    void SetAllocationReport(bool is_print_allocations) {
+        m_is_print_allocations = is_print_allocations;
+    }
+
+    void SetMaxFailures(uint64_t max_failed_tests, uint64_t max_failed_asserts) {
+        m_max_failed_tests      = max_failed_tests;
+        m_max_failed_asserts    = max_failed_asserts;
+    }
+
+    bool IsCancelled() const {
+        return m_is_cancelled.load(std::memory_order_relaxed);
+    }
+
+    void SetTimeout(uint64_t test_timeout, uint64_t run_timeout) {
+        m_test_timeout  = test_timeout;
+        m_run_timeout   = run_timeout;
+    }
+
+    uint64_t GetTotalTime() const {
+        return m_total_time;
+    }
+
+    void RequestAbort() {
+        ToCurrentTestResult().is_request_abort = true;
+    }
+
+    void IncNumOfAssertExecutions() {
+        TTK_ToNumberOfExecutedAsserts() += 1;
+    }
+
+private:
+    // Displays summary of run and notifies reporters. Returns true, if none of test functions has failed.
+    bool EndRun() {
+        m_total_time = TTK_GetTime() - m_run_begin_time;
+
+        const bool is_success = m_number_of_failed_tests == 0;
+
+        m_output.Print("%s", (is_success ? "--- TEST SUCCESS ---\n" : "--- TEST FAIL ---\n"));
+        m_output.Print("number of executed asserts      : %lld\n", m_number_of_executed_asserts);
+        m_output.Print("number of failed asserts        : %lld\n", m_number_of_failed_asserts);
+        m_output.Print("number of executed tests        : %lld\n", m_number_of_executed_tests);
+        m_output.Print("number of failed tests          : %lld\n", m_number_of_failed_tests);
+
+        if (m_is_print_test_time || m_number_of_slowest_tests > 0) PrintTimeSummary();
+        if (m_is_print_allocations) PrintAllocationSummary();
+
+        const TTK_RunSummary summary = {
+            m_number_of_executed_asserts, 
+            m_number_of_failed_asserts, 
+            m_number_of_executed_tests, 
+            m_number_of_failed_tests, 
+            m_total_time, 
+            is_success
+        };
+        for (TTK_Reporter* reporter : m_reporters) reporter->OnRunEnd(summary);
+
+        return is_success;
+    }
+
+    uint32_t SolveNumberOfWorkers() const {
+        if (m_number_of_workers == 0) {
+            const uint32_t number_of_hardware_threads = std::thread::hardware_concurrency();
+            return number_of_hardware_threads ? number_of_hardware_threads : 1;
+        }
+        return m_number_of_workers;
+    }
+
+    // Solves shard from settings or from environment variables.
+    void SolveShard(uint32_t& shard_index, uint32_t& number_of_shards) const {
+        shard_index         = m_shard_index;
+        number_of_shards    = m_number_of_shards;
+
+        if (!m_is_shard_set) {
+            const std::string shard_index_text          = TTK_GetEnvironmentVariable("TTK_SHARD_INDEX");
+            const std::string number_of_shards_text     = TTK_GetEnvironmentVariable("TTK_SHARD_COUNT");
+
+            if (!shard_index_text.empty() && !number_of_shards_text.empty()) {
+                shard_index         = uint32_t(strtoul(shard_index_text.c_str(), nullptr, 10));
+                number_of_shards    = uint32_t(strtoul(number_of_shards_text.c_str(), nullptr, 10));
+            }
+        }
+    }
+
+    // Solves seed of properties from settings, from environment variable or from clock.
+    uint64_t SolvePropertySeed() const {
+        if (m_property_seed) return m_property_seed;
+
+        const std::string seed_text = TTK_GetEnvironmentVariable("TTK_PROPERTY_SEED");
+        const uint64_t seed = seed_text.empty() ? TTK_GetTime() : uint64_t(strtoull(seed_text.c_str(), nullptr, 0));
+        return seed ? seed : 1;
+    }
+
+    // Solves mode of baselines from settings or from environment variable.
+    TTK_BaselineMode SolveBaselineMode() const {
+        const std::string mode_text = TTK_GetEnvironmentVariable("TTK_BASELINE_MODE");
+
+        if (mode_text == "check")   return TTK_BASELINE_CHECK;
+        if (mode_text == "record")  return TTK_BASELINE_RECORD;
+        if (mode_text == "update")  return TTK_BASELINE_UPDATE;
+        return m_baseline_mode;
+    }
+
+    // Solves mode of result cache from settings or from environment variable.
+    TTK_ResultCacheMode SolveResultCacheMode() const {
+        if (m_result_cache_file_name.empty()) return TTK_CACHE_RUN_ALL;
+
+        const std::string mode_text = TTK_GetEnvironmentVariable("TTK_RESULT_CACHE_MODE");
+
+        if (mode_text == "all")             return TTK_CACHE_RUN_ALL;
+        if (mode_text == "failed")          return TTK_CACHE_RUN_FAILED;
+        if (mode_text == "failed_first")    return TTK_CACHE_FAILED_FIRST;
+        if (mode_text == "incremental")     return TTK_CACHE_RUN_INCREMENTAL;
+        return m_result_cache_mode;
+    }
+
+    // Destroys constructed fixtures, in reverse order of construction.
+    void DestroyFixtures() {
+        std::vector<TTK_FixtureBase*> fixtures;
+        {
+            std::lock_guard<std::mutex> lock(m_fixture_mutex);
+            fixtures.swap(m_constructed_fixtures);
+        }
+
+        for (size_t index = fixtures.size(); index-- > 0;) fixtures[index]->Destroy();
+    }
+
+    // Loads baselines at first call in current run, so run without TTK_ASSERT_NOT_SLOWER doesn't read file of baselines.
+    // Can be called by many workers at once.
+    void LoadBaselines() {
+        std::lock_guard<std::mutex> lock(m_baseline_load_mutex);
+
+        if (!m_is_baselines_loaded) {
+            m_is_baselines_loaded = true;
+
+            if (!m_baselines.Load(m_baseline_file_name)) {
+                m_output.Print("TTK Error: Can not load baselines from file: %s\n", m_baseline_file_name.c_str());
+            }
+        }
+    }
+
+    // Adds results of executed test functions to result cache and saves it (if cache file is set).
+    void SaveResultCache() {
+        if (m_result_cache_file_name.empty()) return;
+
+        m_result_cache.Update(m_test_records, m_binary_identity);
+        if (!m_result_cache.Save(m_result_cache_file_name)) {
+            m_output.Print("TTK Error: Can not save result cache to file: %s\n", m_result_cache_file_name.c_str());
+        }
+    }
+
+    // Marks test functions, which cached result is failed (is_fail is true) or passed (is_fail is false). 
+    // If is_current_binary_only is true, then only results made by current binary are taken.
+    // Returns true, if any test function has been marked.
+    bool MarkByResultCache(bool is_fail, bool is_current_binary_only, std::vector<char>& is_marked_list) {
+        bool is_any_marked = false;
+        is_marked_list.assign(m_tests.GetNumberOfTests(), false);
+
+        for (const TTK_CachedResult& result : m_result_cache.GetResults()) {
+            if (result.is_fail != is_fail) continue;
+            if (is_current_binary_only && result.binary_identity != m_binary_identity) continue;
+
+            const std::pair<const TTK_Register::SizeType*, const TTK_Register::SizeType*> range = m_tests.FindByNamePrefix(result.name);
+
+            for (const TTK_Register::SizeType* index = range.first; index != range.second; ++index) {
+                if (result.name == m_tests.ToTest(*index).name) {
+                    is_marked_list[*index]  = true;
+                    is_any_marked           = true;
+                }
+            }
+        }
+
+        return is_any_marked;
+    }
+
+    // Marks test functions which pass filters by name. 
+    // Returns empty list, if there is no filter.
+    std::vector<char> SelectByName() {
+        const std::vector<TTK_NameFilter> environment_filters = m_filters.empty() ? TTK_NameFilter::Parse(TTK_GetEnvironmentVariable("TTK_FILTER")) : std::vector<TTK_NameFilter>();
+        const std::vector<TTK_NameFilter>& filters = m_filters.empty() ? environment_filters : m_filters;
+
+        std::vector<char> is_selected_list;
+        if (filters.empty()) return is_selected_list;
+
+        const bool is_include = std::any_of(filters.begin(), filters.end(), [](const TTK_NameFilter& filter) { return !filter.IsExclude(); });
+        is_selected_list.assign(m_tests.GetNumberOfTests(), !is_include);
+
+        // include filters first, so exclude filters always win
+        for (const bool is_exclude : {false, true}) {
+            for (const TTK_NameFilter& filter : filters) {
+                if (filter.IsExclude() != is_exclude) continue;
+
+                const std::pair<const TTK_Register::SizeType*, const TTK_Register::SizeType*> range = m_tests.FindByNamePrefix(filter.GetPrefix());
+
+                for (const TTK_Register::SizeType* index = range.first; index != range.second; ++index) {
+                    if (filter.IsMatch(m_tests.ToTest(*index).name)) is_selected_list[*index] = !is_exclude;
+                }
+            }
+        }
+
+        return is_selected_list;
+    }
+
+    // Marks test functions which satisfy filter by tags, one bit per test function (see TTK_TagFilter::Select). 
+    // Returns false, if there is no filter.
+    bool SelectByTags(std::vector<uint64_t>& is_selected_set) {
+        if (m_tag_filter) {
+            is_selected_set = m_tag_filter->Select(m_tests);
+            return true;
+        }
+
+        const std::string expression = TTK_GetEnvironmentVariable("TTK_TAGS");
+        if (expression.empty()) return false;
+
+        const TTK_TagFilter tag_filter(expression);
+        if (!tag_filter.IsValid()) {
+            m_output.Print("TTK Error: Invalid tag expression in TTK_TAGS: %s\n", expression.c_str());
+            return false;
+        }
+
+        is_selected_set = tag_filter.Select(m_tests);
+        return true;
+    }
+
+    // Returns indices of test functions to be executed, in order of execution.
+    std::vector<TTK_Register::SizeType> SelectTests() {
+        std::vector<TTK_Register::SizeType> indices;
+
+        uint32_t shard_index        = 0;
+        uint32_t number_of_shards   = 0;
+        SolveShard(shard_index, number_of_shards);
+
+        const bool is_sharded = number_of_shards > 1;
+
+        const std::vector<char> is_selected_list = SelectByName();
+
+        std::vector<uint64_t> is_selected_by_tags_set;
+        const bool is_tag_filter = SelectByTags(is_selected_by_tags_set);
+
+        std::vector<char> is_failed_list;   // by result cache
+        std::vector<char> is_passed_list;   // by result cache, in current binary
+
+        const bool is_only_failed = m_result_cache_run_mode == TTK_CACHE_RUN_FAILED && MarkByResultCache(true, false, is_failed_list);
+        const bool is_failed_first = m_result_cache_run_mode == TTK_CACHE_FAILED_FIRST && MarkByResultCache(true, false, is_failed_list);
+        const bool is_skip_passed = m_result_cache_run_mode == TTK_CACHE_RUN_INCREMENTAL && MarkByResultCache(false, true, is_passed_list);
+
+        for (TTK_Register::SizeType index = 0; index < m_tests.GetNumberOfTests(); ++index) {
+            const TTK_TestData& test_data = m_tests.ToTest(index);
+
+            if (test_data.mode & TTK_DISABLE) continue;
+            if (!is_selected_list.empty() && !is_selected_list[index]) continue;
+            if (is_tag_filter && !((is_selected_by_tags_set[index / 64] >> (index % 64)) & 1)) continue;
+            if (is_sharded && TTK_HashName(test_data.name) % number_of_shards != shard_index) continue;
+            if (is_only_failed && !is_failed_list[index]) continue;
+            if (is_skip_passed && is_passed_list[index]) continue;
+
+            indices.push_back(index);
+        }
+
+        const bool is_longest_first = m_is_longest_first && !m_result_cache_file_name.empty();
+
+        if (is_failed_first || is_longest_first) OrderTests(indices, is_failed_first ? is_failed_list : std::vector<char>(), is_longest_first);
+
+        return indices;
+    }
+
+    // Moves previously failed test functions (marked in is_failed_list) to the front, and then (if is_longest_first) orders test functions 
+    // by cached durations from the longest, which is longest processing time first schedule for workers. 
+    // Test functions without cached duration are treated as the longest. Test functions with TTK_KEEP_ORDER stay in their places.
+    void OrderTests(std::vector<TTK_Register::SizeType>& indices, const std::vector<char>& is_failed_list, bool is_longest_first) {
+        struct Entry {
+            TTK_Register::SizeType  index;
+            bool                    is_failed;
+            bool                    is_duration;
+            uint64_t                duration;       // cached, in nanoseconds
+        };
+
+        std::vector<size_t> positions;  // of movable test functions
+        std::vector<Entry>  entries;
+
+        for (size_t position = 0; position < indices.size(); ++position) {
+            const TTK_TestData& test_data = m_tests.ToTest(indices[position]);
+            if (test_data.mode & TTK_KEEP_ORDER) continue;
+
+            const TTK_CachedResult* result = is_longest_first ? m_result_cache.Find(test_data.name) : nullptr;
+
+            positions.push_back(position);
+            entries.push_back({indices[position], !is_failed_list.empty() && is_failed_list[indices[position]], result != nullptr, result ? result->duration : 0});
+        }
+
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) {
+            if (l.is_failed != r.is_failed) return l.is_failed;
+            if (l.is_duration != r.is_duration) return !l.is_duration;
+            return l.duration > r.duration;
+        });
+
+        for (size_t entry_index = 0; entry_index < entries.size(); ++entry_index) indices[positions[entry_index]] = entries[entry_index].index;
+    }
+
+    TTK_TestResult& ToCurrentTestResult() {
+        TTK_TestResult* test_result = TTK_ToCurrentTestResult();
+        return test_result ? *test_result : m_stray_test_result;
+    }
+
+    // Adds each case as separate test function. Takes ownership of case set.
+    void AddTestCases(TTK_CaseSet* case_set, TTK_CaseFnP_T case_function, const char* name, uint64_t number_of_cases, uint64_t mode) {
+        m_case_sets.push_back(std::unique_ptr<TTK_CaseSet>(case_set));
+        m_tests.Reserve(m_tests.GetNumberOfTests() + number_of_cases);
+
+        const char* case_name = case_set->MakeNames(name, number_of_cases);
+
+        for (uint64_t case_index = 0; case_index < number_of_cases; ++case_index) {
+            AddTest({nullptr, case_name, mode, case_function, case_set, case_index, nullptr});
+            case_name += strlen(case_name) + 1;
+        }
+    }
+
+    static void ExecuteTest(const TTK_TestData& test_data, TTK_TestResult& test_result) {
+        TTK_ToCurrentTestResult()       = &test_result;
+        TTK_ToNumberOfExecutedAsserts() = 0;
+
+        TTK_AllocationCounters& allocation_counters = TTK_ToAllocationCounters();
+        const TTK_AllocationCounters begin_allocation_counters = allocation_counters;
+        allocation_counters.peak_bytes = allocation_counters.current_bytes;
+
+        const uint64_t begin_time = TTK_GetTime();
+        if (test_data.case_function) {
+            test_data.case_function(test_data.case_set, test_data.case_index);
+        } else {
+            test_data.function();
+        }
+        test_result.duration = TTK_GetTime() - begin_time;
+
+        test_result.number_of_allocations   = allocation_counters.number_of_allocations - begin_allocation_counters.number_of_allocations;
+        test_result.allocated_bytes         = allocation_counters.allocated_bytes - begin_allocation_counters.allocated_bytes;
+        test_result.peak_allocated_bytes    = uint64_t(allocation_counters.peak_bytes - begin_allocation_counters.current_bytes);
+
+        test_result.number_of_executed_asserts = TTK_ToNumberOfExecutedAsserts();
+        TTK_ToCurrentTestResult() = nullptr;
+    }
+
+    static bool IsAbortingRemainingTests(const TTK_TestData& test_data, const TTK_TestResult& test_result) {
+        return test_result.number_of_failed_asserts != 0 && test_result.is_request_abort && !(test_data.mode & TTK_NO_ABORT);
+    }
+
+    void BeginTest(const TTK_TestData& test_data) {
+        PrintTestName(test_data);
+        for (TTK_Reporter* reporter : m_reporters) reporter->OnTestBegin(test_data);
+    }
+
+    // Passes communicate to reporters.
+    void NotifyCommunicate(const TTK_CommunicateData& communicate) {
+        for (TTK_Reporter* reporter : m_reporters) {
+            if (communicate.kind == TTK_COMMUNICATE_KIND_NOTE) {
+                reporter->OnNote(communicate.message);
+            } else {
+                reporter->OnAssertFail(communicate);
+            }
+        }
+    }
+
+    void PrintTestName(const TTK_TestData& test_data) {
+        m_output.Print("[test] %s\n", test_data.name);
+        m_output.FlushIfDirect();
+    }
+
+    void PrintCommunicate(const TTK_CommunicateData& communicate) {
+        if (communicate.kind == TTK_COMMUNICATE_KIND_CRASH) {
+            m_output.Print("    [fail] [crash:%s]\n", communicate.message.c_str());
+            m_output.Flush();
+        } else if (communicate.kind == TTK_COMMUNICATE_KIND_TIMEOUT) {
+            m_output.Print("    [fail] [timeout:%s]\n", communicate.message.c_str());
+            m_output.Flush();
+        } else if (communicate.kind == TTK_COMMUNICATE_KIND_NOTE) {
+            PrintNote(communicate.message.c_str());
+        } else {
+            PrintAssertFail(communicate.line, communicate.condition, communicate.file_name_utf8, communicate.is_message ? communicate.message.c_str() : nullptr);
+        }
+    }
+
+    void PrintNote(const char* text) {
+        m_output.Print("    %s\n", text);
+        m_output.FlushIfDirect();
+    }
+
+    void PrintAssertFail(unsigned line, const char* condition, const char* file_name_utf8, const char* message) {
+        if (m_output.GetFile()) {
+            m_output.Print("    [fail] [file:%s] [line:%d] [condition:%s]", file_name_utf8, line, condition);
+            if (message) {
+                m_output.Print(" [message:%s]\n", message);
+            } else {
+                m_output.Print("\n");
+            }
+            m_output.Flush();
+        }
+    }
+
+    void PrintTestTime(const TTK_TestResult& test_result) {
+        m_output.Print("    [time] %.3f ms\n", test_result.duration / 1e6);
+        m_output.FlushIfDirect();
+    }
+
+    void PrintTimeSummary() {
+        std::vector<TTK_TestRecord> slowest_tests(m_test_records);
+        const size_t number_of_slowest_tests = std::min<size_t>(m_number_of_slowest_tests, slowest_tests.size());
+
+        std::partial_sort(slowest_tests.begin(), slowest_tests.begin() + number_of_slowest_tests, slowest_tests.end(), [](const TTK_TestRecord& l, const TTK_TestRecord& r) {
+            return l.duration > r.duration;
+        });
+
+        m_output.Print("total time                      : %.3f s\n", m_total_time / 1e9);
+        if (number_of_slowest_tests > 0) m_output.Print("%s", "slowest tests                   :\n");
+        for (size_t index = 0; index < number_of_slowest_tests; ++index) {
+            m_output.Print("    %12.3f ms %s\n", slowest_tests[index].duration / 1e6, slowest_tests[index].name);
+        }
+    }
+
+    void PrintAllocationSummary() {
+        if (!TTK_ToIsAllocationCounted()) {
+            m_output.Print("%s", "allocations                     : not counted (TTK_ALLOCATION_HOOKS is not defined)\n");
+            return;
+        }
+
+        uint64_t number_of_allocations  = 0;
+        uint64_t allocated_bytes        = 0;
+        const TTK_TestRecord* peak_record = nullptr;
+
+        for (const TTK_TestRecord& record : m_test_records) {
+            number_of_allocations   += record.number_of_allocations;
+            allocated_bytes         += record.allocated_bytes;
+            if (!peak_record || record.peak_allocated_bytes > peak_record->peak_allocated_bytes) peak_record = &record;
+        }
+
+        m_output.Print("number of allocations           : %llu\n", (unsigned long long)number_of_allocations);
+        m_output.Print("allocated bytes                 : %llu\n", (unsigned long long)allocated_bytes);
+        if (peak_record) {
+            m_output.Print("peak allocated bytes            : %llu (%s)\n", (unsigned long long)peak_record->peak_allocated_bytes, peak_record->name);
+        }
+    }
+
+    // Adds result of executed test function to the summary.
+    // Returns false, if remaining test functions should be aborted.
+    bool CommitTestResult(const TTK_TestData& test_data, const TTK_TestResult& test_result) {
+        m_number_of_executed_asserts    += test_result.number_of_executed_asserts;
+        m_number_of_failed_asserts      += test_result.number_of_failed_asserts;
+
+        m_number_of_executed_tests      += 1;
+        if (test_result.number_of_failed_asserts != 0) m_number_of_failed_tests += 1;
+
+        if (!test_result.recorded_baselines.empty()) LoadBaselines();
+        for (const std::pair<std::string, double>& baseline : test_result.recorded_baselines) m_baselines.Set(baseline.first, baseline.second);
+
+        m_test_records.push_back({
+            test_data.name, 
+            test_result.duration, 
+            test_result.number_of_failed_asserts != 0, 
+            test_result.number_of_allocations, 
+            test_result.allocated_bytes, 
+            test_result.peak_allocated_bytes
+        });
+        if (m_is_print_test_time) PrintTestTime(test_result);
+
+        for (TTK_Reporter* reporter : m_reporters) reporter->OnTestEnd(test_data, test_result);
+
+        return !IsAbortingRemainingTests(test_data, test_result);
+    }
+
+    // Displays stored communicates of test function executed by worker, and adds its result to the summary.
+    // Returns false, if remaining test functions should be aborted.
+    bool CommitDeferredTestResult(const TTK_TestData& test_data, TTK_TestResult& test_result) {
+        BeginTest(test_data);
+        for (const TTK_CommunicateData& communicate : test_result.communicates) {
+            PrintCommunicate(communicate);
+            NotifyCommunicate(communicate);
+        }
+        std::vector<TTK_CommunicateData>().swap(test_result.communicates);
+
+        return CommitTestResult(test_data, test_result);
+    }
+
+    // Returns timeout of test function, in nanoseconds. 0 - no timeout.
+    uint64_t SolveTimeout(const TTK_TestData& test_data) const {
+        const uint64_t timeout = test_data.mode >> 32; // see TTK_TIMEOUT_MS
+        return timeout ? timeout * 1000000 : m_test_timeout;
+    }
+
+    bool IsAnyTimeout(const std::vector<TTK_Register::SizeType>& indices) const {
+        if (m_run_timeout || m_test_timeout) return true;
+        for (TTK_Register::SizeType index : indices) {
+            if (m_tests.ToTest(index).mode >> 32) return true;
+        }
+        return false;
+    }
+
+    static std::string FormatTimeout(uint64_t timeout, bool is_run_timeout) {
+        char text[64] = {};
+        snprintf(text, sizeof(text), "%s%.3f ms", is_run_timeout ? "run " : "", timeout / 1e6);
+        return text;
+    }
+
+    void PrintCancel(uint64_t number_of_tests) {
+        m_output.Print("TTK Error: Limit of failures has been reached. Number of not executed tests: %llu.\n", 
+            (unsigned long long)(number_of_tests - m_number_of_executed_tests));
+    }
+
+    // Counts failed asserts towards limit of failures. Cancels run, when limit is reached. Can be called by many workers at once.
+    void CountFailedAsserts(uint64_t number_of_failed_asserts) {
+        if (m_max_failed_asserts && (m_number_of_live_failed_asserts += number_of_failed_asserts) >= m_max_failed_asserts) m_is_cancelled = true;
+    }
+
+    // Counts finished test function towards limits of failures. Cancels run, when limit is reached. Can be called by many workers at once.
+    // is_count_asserts     If false, then failed asserts have been already counted when they were communicated.
+    void CountFailures(const TTK_TestResult& test_result, bool is_count_asserts) {
+        if (is_count_asserts) CountFailedAsserts(test_result.number_of_failed_asserts);
+        if (test_result.number_of_failed_asserts != 0 && m_max_failed_tests && ++m_number_of_live_failed_tests >= m_max_failed_tests) m_is_cancelled = true;
+    }
+
+    void PrintRunTimeout(uint64_t number_of_tests) {
+        m_output.Print("TTK Error: Run timeout (%.3f ms) has been exceeded. Number of not executed tests: %llu.\n", 
+            m_run_timeout / 1e6, (unsigned long long)(number_of_tests - m_number_of_executed_tests));
+    }
+
+    void PrintTestTimeout(uint64_t number_of_tests) {
+        m_output.Print("TTK Error: Timeout of test function has been exceeded. Number of not executed tests: %llu.\n", 
+            (unsigned long long)(number_of_tests - m_number_of_executed_tests));
+    }
+
+    // Test function executed by single thread, as seen by watchdog.
+    struct WatchSlot {
+        std::atomic<uint64_t>           deadline;       // 0 - no test function is executed, UINT64_MAX - executed test function has no timeout
+        std::atomic<uint64_t>           timeout;
+        std::atomic<uint64_t>           begin_time;
+        std::atomic<size_t>             position;
+        std::atomic<TTK_TestResult*>    test_result;    // deferred, so its stored fails and notes can be taken by watchdog
+    };
+
+    // Watches test functions executed on threads. Started only when any timeout is set.
+    struct Watchdog {
+        Watchdog() {
+            number_of_slots     = 0;
+            run_deadline        = 0;
+            indices             = nullptr;
+            is_stop_request     = false;
+        }
+
+        std::unique_ptr<WatchSlot[]>                slots;
+        uint32_t                                    number_of_slots;
+        uint64_t                                    run_deadline;       // 0 - no run timeout
+        const std::vector<TTK_Register::SizeType>*  indices;
+        std::function<void()>                       commit_finished;    // commits test functions, which have been finished before timeout
+
+        std::thread                                 thread;
+        std::mutex                                  mutex;
+        std::condition_variable                     condition;
+        bool                                        is_stop_request;
+    };
+
+    enum : uint32_t {
+        WATCH_INTERVAL = 10, // in milliseconds
+    };
+
+    // Returns false, if watchdog is not needed (no timeout is set). 
+    // Watched test functions must be deferred, so stuck ones don't display anything while watchdog displays summary.
+    bool StartWatchdog(Watchdog& watchdog, const std::vector<TTK_Register::SizeType>& indices, uint32_t number_of_slots, std::function<void()> commit_finished) {
+        if (!IsAnyTimeout(indices)) return false;
+
+        watchdog.slots.reset(new WatchSlot[number_of_slots]);
+        for (uint32_t slot_index = 0; slot_index < number_of_slots; ++slot_index) {
+            watchdog.slots[slot_index].deadline     = 0;
+            watchdog.slots[slot_index].timeout      = 0;
+            watchdog.slots[slot_index].begin_time   = 0;
+            watchdog.slots[slot_index].position     = 0;
+            watchdog.slots[slot_index].test_result  = nullptr;
+        }
+
+        watchdog.number_of_slots    = number_of_slots;
+        watchdog.run_deadline       = m_run_timeout ? m_run_begin_time + m_run_timeout : 0;
+        watchdog.indices            = &indices;
+        watchdog.commit_finished    = commit_finished;
+
+        watchdog.thread = std::thread([this, &watchdog]() { Watch(watchdog); });
+        return true;
+    }
+
+    static void StopWatchdog(Watchdog& watchdog) {
+        if (!watchdog.thread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(watchdog.mutex);
+            watchdog.is_stop_request = true;
+        }
+        watchdog.condition.notify_all();
+        watchdog.thread.join();
+    }
+
+    static void BeginWatch(Watchdog& watchdog, uint32_t slot_index, size_t position, TTK_TestResult& test_result, uint64_t timeout) {
+        WatchSlot& slot = watchdog.slots[slot_index];
+        const uint64_t begin_time = TTK_GetTime();
+
+        slot.position       = position;
+        slot.test_result    = &test_result;
+        slot.timeout        = timeout;
+        slot.begin_time     = begin_time;
+        slot.deadline       = timeout ? begin_time + timeout : UINT64_MAX; // last, so watchdog sees complete slot
+    }
+
+    static void EndWatch(Watchdog& watchdog, uint32_t slot_index) {
+        watchdog.slots[slot_index].deadline = 0;
+    }
+
+    void Watch(Watchdog& watchdog) {
+        std::unique_lock<std::mutex> lock(watchdog.mutex);
+
+        while (!watchdog.is_stop_request) {
+            watchdog.condition.wait_for(lock, std::chrono::milliseconds(WATCH_INTERVAL));
+            if (watchdog.is_stop_request) break;
+
+            const uint64_t now = TTK_GetTime();
+            bool is_overdue = watchdog.run_deadline && now >= watchdog.run_deadline;
+
+            for (uint32_t slot_index = 0; slot_index < watchdog.number_of_slots; ++slot_index) {
+                const uint64_t deadline = watchdog.slots[slot_index].deadline;
+                if (deadline && now >= deadline) is_overdue = true;
+            }
+
+            if (is_overdue) {
+                lock.unlock();
+                TerminateStuckRun(watchdog, now);
+            }
+        }
+    }
+
+    // Thread which executes stuck test function can't be stopped safely, so test functions finished so far, stuck test functions (as failed) 
+    // and summary are displayed, and then process is terminated. 
+    // Fails and notes stored by stuck test functions so far are displayed, and later ones are discarded. 
+    // Asserts executed by stuck test functions are counted on their threads, so they aren't in summary.
+    TTK_COLD
+    void TerminateStuckRun(Watchdog& watchdog, uint64_t now) {
+        std::lock_guard<std::mutex> commit_lock(m_commit_mutex);
+
+        if (watchdog.commit_finished) watchdog.commit_finished();
+
+        const bool is_run_timeout = watchdog.run_deadline && now >= watchdog.run_deadline;
+
+        std::vector<std::pair<size_t, uint32_t>> stuck_slots; // position, slot index
+        for (uint32_t slot_index = 0; slot_index < watchdog.number_of_slots; ++slot_index) {
+            const uint64_t deadline = watchdog.slots[slot_index].deadline;
+            if (deadline && (is_run_timeout || now >= deadline)) stuck_slots.push_back({watchdog.slots[slot_index].position, slot_index});
+        }
+        std::sort(stuck_slots.begin(), stuck_slots.end());
+
+        std::vector<TTK_TestResult> stuck_results(stuck_slots.size());
+        {
+            std::lock_guard<std::mutex> lock(m_deferred_mutex);
+            m_is_deferred_stopped = true;
+
+            for (size_t stuck_index = 0; stuck_index < stuck_slots.size(); ++stuck_index) {
+                const TTK_TestResult* test_result = watchdog.slots[stuck_slots[stuck_index].second].test_result;
+                if (!test_result) continue;
+
+                stuck_results[stuck_index].number_of_failed_asserts = test_result->number_of_failed_asserts;
+                stuck_results[stuck_index].communicates             = test_result->communicates;
+            }
+        }
+
+        for (size_t stuck_index = 0; stuck_index < stuck_slots.size(); ++stuck_index) {
+            const WatchSlot&    slot        = watchdog.slots[stuck_slots[stuck_index].second];
+            const TTK_TestData& test_data   = m_tests.ToTest((*watchdog.indices)[stuck_slots[stuck_index].first]);
+            const bool          is_expired  = slot.timeout && now >= slot.deadline;
+            TTK_TestResult&     test_result = stuck_results[stuck_index];
+
+            test_result.duration                    = now - slot.begin_time;
+            test_result.number_of_failed_asserts    += 1;
+            test_result.is_request_abort            = true;
+            test_result.communicates.push_back({TTK_COMMUNICATE_KIND_TIMEOUT, 0, nullptr, nullptr, FormatTimeout(is_expired ? slot.timeout.load() : m_run_timeout, !is_expired), true});
+
+            CommitDeferredTestResult(test_data, test_result);
+        }
+
+        if (is_run_timeout) {
+            PrintRunTimeout(watchdog.indices->size());
+        } else {
+            PrintTestTimeout(watchdog.indices->size());
+        }
+
+        SaveResultCache();
+        EndRun();
+        m_output.End();
+        fflush(nullptr);
+
+        _Exit(EXIT_FAILURE);
+    }
+
+    void RunOnCurrentThread(const std::vector<TTK_Register::SizeType>& indices) {
+        Watchdog watchdog;
+        const bool is_watched = StartWatchdog(watchdog, indices, 1, nullptr);
+
+        for (size_t position = 0; position < indices.size(); ++position) {
+            const TTK_TestData& test_data = m_tests.ToTest(indices[position]);
+            TTK_TestResult test_result = {};
+
+            test_result.is_deferred = is_watched;
+            if (!is_watched) BeginTest(test_data);
+
+            if (is_watched) BeginWatch(watchdog, 0, position, test_result, SolveTimeout(test_data));
+            ExecuteTest(test_data, test_result);
+            if (is_watched) EndWatch(watchdog, 0);
+
+            CountFailures(test_result, false);
+
+            std::lock_guard<std::mutex> commit_lock(m_commit_mutex);
+            const bool is_continue = is_watched ? CommitDeferredTestResult(test_data, test_result) : CommitTestResult(test_data, test_result);
+            if (!is_continue || IsCancelled()) break; // abort all tests
+        }
+
+        StopWatchdog(watchdog);
+    }
+
+    // States of test functions in 'is_done_list' of RunOnWorkers and RunInChildProcesses.
+    enum : char {
+        TEST_NOT_DONE   = 0,
+        TEST_DONE       = 1,
+        TEST_SKIPPED    = 2,    // not executed (or killed), because run has been cancelled
+    };
+
+    // Test functions are taken by workers in order of adding. 
+    // Results are communicated by calling thread in the same order, as soon as they are available, 
+    // so output is the same as for execution on single thread.
+    // After cancellation, workers skip remaining test functions, and only executed ones are communicated.
+    void RunOnWorkers(const std::vector<TTK_Register::SizeType>& indices, uint32_t number_of_workers) {
+        const size_t                count = indices.size();
+
+        std::vector<TTK_TestResult> test_results(count);
+        std::vector<char>           is_done_list(count, TEST_NOT_DONE);
+
+        std::mutex                  mutex;
+        std::condition_variable     done_condition;
+
+        std::atomic<size_t>         next_position(0);
+        std::atomic<size_t>         abort_position(count); // position of first test function which aborts remaining test functions
+
+        if (number_of_workers > count) number_of_workers = uint32_t(count);
+
+        size_t commit_position = 0;
+
+        Watchdog watchdog;
+        const bool is_watched = StartWatchdog(watchdog, indices, number_of_workers, [&]() {
+            for (; commit_position < count; ++commit_position) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!is_done_list[commit_position]) break;
+                }
+                if (is_done_list[commit_position] == TEST_SKIPPED) continue;
+                if (!CommitDeferredTestResult(m_tests.ToTest(indices[commit_position]), test_results[commit_position])) break;
+            }
+        });
+
+        auto Work = [&](uint32_t worker_index) {
+            TTK_ToWorkerIndex() = worker_index;
+
+            for (;;) {
+                const size_t position = next_position.fetch_add(1);
+                if (position >= count || position > abort_position.load()) break;
+
+                if (IsCancelled()) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        is_done_list[position] = TEST_SKIPPED;
+                    }
+                    done_condition.notify_all();
+                    continue;
+                }
+
+                const TTK_TestData& test_data   = m_tests.ToTest(indices[position]);
+                TTK_TestResult&     test_result = test_results[position];
+
+                test_result.is_deferred = true;
+
+                if (is_watched) BeginWatch(watchdog, worker_index, position, test_result, SolveTimeout(test_data));
+                ExecuteTest(test_data, test_result);
+                if (is_watched) EndWatch(watchdog, worker_index);
+
+                CountFailures(test_result, false);
+
+                if (IsAbortingRemainingTests(test_data, test_result)) {
+                    size_t current = abort_position.load();
+                    while (position < current && !abort_position.compare_exchange_weak(current, position)) {}
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    is_done_list[position] = TEST_DONE;
+                }
+                done_condition.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (uint32_t worker_index = 0; worker_index < number_of_workers; ++worker_index) workers.emplace_back(Work, worker_index);
+
+        for (size_t position = 0; position < count; ++position) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                done_condition.wait(lock, [&]() { return is_done_list[position] != 0; });
+            }
+
+            std::lock_guard<std::mutex> commit_lock(m_commit_mutex);
+            commit_position = position + 1;
+            if (is_done_list[position] == TEST_SKIPPED) continue;
+            if (!CommitDeferredTestResult(m_tests.ToTest(indices[position]), test_results[position])) { // abort all tests
+                commit_position = count;
+                break; 
+            }
+        }
+
+        for (std::thread& worker : workers) worker.join();
+
+        StopWatchdog(watchdog);
+    }
+
+    static bool IsProcessIsolationAvailable() {
+#ifdef TTK_PROCESS_ISOLATION_AVAILABLE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef TTK_PROCESS_ISOLATION_AVAILABLE
+    // Child process sends to parent process records through pipe:
+    //     'F' - failed assertion, sent as soon as assertion fails, so it's not lost when child process crashes later,
+    //     'N' - note, sent as soon as it's communicated,
+    //     'B' - baseline recorded by TTK_ASSERT_NOT_SLOWER,
+    //     'E' - end of test function with final numbers of asserts.
+    // Pointers to condition and file name are sent as they are, because child process shares memory layout with parent process.
+    template <typename Type>
+    static void AppendValue(std::string& data, const Type& value) {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(Type));
+    }
+
+    template <typename Type>
+    static bool TakeValue(const std::string& data, size_t& offset, Type& value) {
+        if (offset + sizeof(Type) > data.size()) return false;
+        memcpy(&value, data.data() + offset, sizeof(Type));
+        offset += sizeof(Type);
+        return true;
+    }
+
+    static void WriteToDescriptor(int descriptor, const std::string& data) {
+        size_t offset = 0;
+        while (offset < data.size()) {
+            const ssize_t count = write(descriptor, data.data() + offset, data.size() - offset);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            offset += size_t(count);
+        }
+    }
+
+    void ReportAssertFail(const TTK_TestResult&, unsigned line, const char* condition, const char* file_name_utf8, const char* message) {
+        std::string data;
+        const uint32_t message_length = message ? uint32_t(strlen(message)) : 0;
+
+        AppendValue(data, 'F');
+        AppendValue(data, TTK_ToNumberOfExecutedAsserts());
+        AppendValue(data, line);
+        AppendValue(data, condition);
+        AppendValue(data, file_name_utf8);
+        AppendValue(data, char(message != nullptr));
+        AppendValue(data, message_length);
+        if (message) data.append(message, message_length);
+
+        WriteToDescriptor(m_report_descriptor, data);
+    }
+
+    void ReportNote(const std::string& text) {
+        std::string data;
+
+        AppendValue(data, 'N');
+        AppendValue(data, uint32_t(text.size()));
+        data += text;
+
+        WriteToDescriptor(m_report_descriptor, data);
+    }
+
+    void ReportBaseline(const std::string& key, double time) {
+        std::string data;
+
+        AppendValue(data, 'B');
+        AppendValue(data, time);
+        AppendValue(data, uint32_t(key.size()));
+        data += key;
+
+        WriteToDescriptor(m_report_descriptor, data);
+    }
+
+    void ReportTestEnd(const TTK_TestResult& test_result) {
+        std::string data;
+
+        AppendValue(data, 'E');
+        AppendValue(data, test_result.number_of_executed_asserts);
+        AppendValue(data, test_result.number_of_failed_asserts);
+        AppendValue(data, test_result.duration);
+        AppendValue(data, test_result.number_of_allocations);
+        AppendValue(data, test_result.allocated_bytes);
+        AppendValue(data, test_result.peak_allocated_bytes);
+        AppendValue(data, char(test_result.is_request_abort));
+
+        WriteToDescriptor(m_report_descriptor, data);
+    }
+
+    // Reconstructs result of test function from records sent by child process and its exit status.
+    // Duration is measured by child process, or by parent process (begin_time) if child process has been terminated.
+    // timeout_message      If isn't nullptr, then child process has been killed after timeout.
+    static void ParseChildReport(const std::string& data, int status, uint64_t begin_time, const char* timeout_message, TTK_TestResult& test_result) {
+        test_result = {};
+        test_result.is_deferred = true;
+        test_result.duration    = TTK_GetTime() - begin_time;
+
+        bool    is_ended = false;
+        size_t  offset   = 0;
+        char    tag      = 0;
+
+        while (!is_ended && TakeValue(data, offset, tag)) {
+            if (tag == 'F') {
+                TTK_CommunicateData  fail = {};
+                char                is_message = 0;
+                uint32_t            message_length = 0;
+
+                fail.kind = TTK_COMMUNICATE_KIND_ASSERT_FAIL;
+
+                if (!TakeValue(data, offset, test_result.number_of_executed_asserts) || !TakeValue(data, offset, fail.line) 
+                        || !TakeValue(data, offset, fail.condition) || !TakeValue(data, offset, fail.file_name_utf8)
+                        || !TakeValue(data, offset, is_message) || !TakeValue(data, offset, message_length) || offset + message_length > data.size()) {
+                    break;
+                }
+                fail.is_message = is_message != 0;
+                fail.message    = data.substr(offset, message_length);
+                offset += message_length;
+
+                test_result.number_of_failed_asserts += 1;
+                test_result.communicates.push_back(fail);
+            } else if (tag == 'N') {
+                uint32_t text_length = 0;
+
+                if (!TakeValue(data, offset, text_length) || offset + text_length > data.size()) break;
+
+                test_result.communicates.push_back({TTK_COMMUNICATE_KIND_NOTE, 0, nullptr, nullptr, data.substr(offset, text_length), true});
+                offset += text_length;
+            } else if (tag == 'B') {
+                double      time        = 0;
+                uint32_t    key_length  = 0;
+
+                if (!TakeValue(data, offset, time) || !TakeValue(data, offset, key_length) || offset + key_length > data.size()) break;
+
+                test_result.recorded_baselines.push_back({data.substr(offset, key_length), time});
+                offset += key_length;
+            } else if (tag == 'E') {
+                char is_request_abort = 0;
+
+                if (!TakeValue(data, offset, test_result.number_of_executed_asserts) || !TakeValue(data, offset, test_result.number_of_failed_asserts) 
+                        || !TakeValue(data, offset, test_result.duration) || !TakeValue(data, offset, test_result.number_of_allocations) 
+                        || !TakeValue(data, offset, test_result.allocated_bytes) || !TakeValue(data, offset, test_result.peak_allocated_bytes) 
+                        || !TakeValue(data, offset, is_request_abort)) {
+                    break;
+                }
+                test_result.is_request_abort = is_request_abort != 0;
+                is_ended = true;
+            } else {
+                break;
+            }
+        }
+
+        if (timeout_message) {
+            test_result.communicates.push_back({TTK_COMMUNICATE_KIND_TIMEOUT, 0, nullptr, nullptr, timeout_message, true});
+            test_result.number_of_failed_asserts    += 1;
+            test_result.is_request_abort            = true;
+        } else if (!is_ended || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::string reason;
+            if (WIFSIGNALED(status)) {
+                reason = std::string("signal ") + ToSignalName(WTERMSIG(status));
+            } else if (WIFEXITED(status)) {
+                reason = "exit code " + std::to_string(WEXITSTATUS(status));
+            } else {
+                reason = "unknown";
+            }
+
+            test_result.communicates.push_back({TTK_COMMUNICATE_KIND_CRASH, 0, nullptr, nullptr, reason, true});
+            test_result.number_of_failed_asserts    += 1;
+            test_result.is_request_abort            = true;
+        }
+    }
+
+    static std::string ToSignalName(int signal_number) {
+        switch (signal_number) {
+        case SIGSEGV:   return "SIGSEGV";
+        case SIGABRT:   return "SIGABRT";
+        case SIGFPE:    return "SIGFPE";
+        case SIGILL:    return "SIGILL";
+        case SIGBUS:    return "SIGBUS";
+        case SIGTRAP:   return "SIGTRAP";
+        case SIGPIPE:   return "SIGPIPE";
+        case SIGTERM:   return "SIGTERM";
+        case SIGKILL:   return "SIGKILL";
+        case SIGINT:    return "SIGINT";
+        default:        return std::to_string(signal_number);
+        }
+    }
+
+    struct ChildProcess {
+        pid_t       pid;
+        int         descriptor;     // read end of pipe
+        size_t      position;
+        uint64_t    begin_time;
+        uint64_t    timeout;        // in nanoseconds, 0 - no timeout
+        std::string data;
+    };
+
+    // Starts child process which executes test function and reports its result through pipe.
+    // Returns false, if child process couldn't be created.
+    bool StartChildProcess(const TTK_TestData& test_data, ChildProcess& child_process) {
+        int descriptors[2] = {-1, -1};
+        if (pipe(descriptors) != 0) return false;
+
+        m_output.Flush();   // writer thread mustn't be in the middle of writing, when process is forked
+        fflush(nullptr);    // prevents output buffered in parent process from being written twice
+
+        const pid_t pid = fork();
+        if (pid < 0) {
+            close(descriptors[0]);
+            close(descriptors[1]);
+            return false;
+        }
+
+        if (pid == 0) {
+            close(descriptors[0]);
+            m_output.Abandon();
+            m_report_descriptor = descriptors[1];
+
+            TTK_TestResult test_result = {};
+            test_result.is_deferred = true;
+
+            ExecuteTest(test_data, test_result);
+            ReportTestEnd(test_result);
+
+            fflush(nullptr);
+            _exit(0);
+        }
+
+        close(descriptors[1]);
+        child_process.begin_time    = TTK_GetTime();
+        child_process.timeout       = SolveTimeout(test_data);
+        child_process.pid           = pid;
+        child_process.descriptor    = descriptors[0];
+        return true;
+    }
+
+    // Waits for end of child process. Returns its exit status.
+    static int FinishChildProcess(ChildProcess& child_process) {
+        close(child_process.descriptor);
+
+        int status = 0;
+        while (waitpid(child_process.pid, &status, 0) < 0 && errno == EINTR) {}
+        return status;
+    }
+
+    // Kills child process after timeout, and reads records which it has sent before.
+    void KillChildProcess(ChildProcess& child_process, const std::string& timeout_message, TTK_TestResult& test_result) {
+        kill(child_process.pid, SIGKILL);
+
+        char buffer[4096];
+        for (;;) {
+            const ssize_t size = read(child_process.descriptor, buffer, sizeof(buffer));
+            if (size > 0) {
+                child_process.data.append(buffer, size_t(size));
+            } else if (size == 0 || errno != EINTR) {
+                break;
+            }
+        }
+
+        const int status = FinishChildProcess(child_process);
+        ParseChildReport(child_process.data, status, child_process.begin_time, timeout_message.c_str(), test_result);
+    }
+
+    // Returns time to the nearest timeout in milliseconds (as expected by poll), or -1 if there is no timeout.
+    int SolvePollTimeout(const std::vector<ChildProcess>& child_processes, uint64_t run_deadline) const {
+        uint64_t deadline = run_deadline ? run_deadline : UINT64_MAX;
+        for (const ChildProcess& child_process : child_processes) {
+            if (child_process.timeout) deadline = std::min(deadline, child_process.begin_time + child_process.timeout);
+        }
+        if (deadline == UINT64_MAX) return -1;
+
+        const uint64_t now = TTK_GetTime();
+        if (now >= deadline) return 0;
+        return int(std::min<uint64_t>((deadline - now + 999999) / 1000000, INT32_MAX));
+    }
+
+    // Each test function is executed in its own child process. At most 'number_of_workers' child processes are executed at the same time.
+    // Results are communicated in order of adding test functions, like in RunOnWorkers.
+    // Child process which exceeds timeout is killed. After run timeout all child processes are killed, and no more child processes are started.
+    // After cancellation, all child processes are killed and their test functions are skipped, as remaining ones.
+    void RunInChildProcesses(const std::vector<TTK_Register::SizeType>& indices, uint32_t number_of_workers) {
+        const size_t                count = indices.size();
+
+        std::vector<TTK_TestResult> test_results(count);
+        std::vector<char>           is_done_list(count, TEST_NOT_DONE);
+        std::vector<ChildProcess>   child_processes;
+
+        size_t                      next_position   = 0;
+        size_t                      commit_position = 0;
+        bool                        is_aborted      = false;
+
+        const uint64_t              run_deadline    = m_run_timeout ? m_run_begin_time + m_run_timeout : 0;
+        bool                        is_run_timeout  = false;
+
+        while (commit_position < count && !is_aborted) {
+            while (!is_run_timeout && next_position < count && child_processes.size() < number_of_workers) {
+                ChildProcess child_process = {};
+                child_process.position = next_position++;
+
+                if (StartChildProcess(m_tests.ToTest(indices[child_process.position]), child_process)) {
+                    child_processes.push_back(child_process);
+                } else {
+                    TTK_TestResult& test_result = test_results[child_process.position];
+                    test_result.communicates.push_back({TTK_COMMUNICATE_KIND_CRASH, 0, nullptr, nullptr, "can not create child process", true});
+                    test_result.number_of_failed_asserts    = 1;
+                    test_result.is_request_abort            = true;
+                    is_done_list[child_process.position]    = TEST_DONE;
+                    CountFailures(test_result, true);
+                }
+            }
+
+            if (!child_processes.empty()) {
+                std::vector<pollfd> poll_descriptors;
+                for (const ChildProcess& child_process : child_processes) poll_descriptors.push_back({child_process.descriptor, POLLIN, 0});
+
+                if (poll(poll_descriptors.data(), nfds_t(poll_descriptors.size()), SolvePollTimeout(child_processes, run_deadline)) < 0 && errno != EINTR) break;
+
+                for (size_t index = poll_descriptors.size(); index-- > 0;) {
+                    if (!poll_descriptors[index].revents) continue;
+
+                    ChildProcess& child_process = child_processes[index];
+
+                    char buffer[4096];
+                    const ssize_t size = read(child_process.descriptor, buffer, sizeof(buffer));
+
+                    if (size > 0) {
+                        child_process.data.append(buffer, size_t(size));
+                    } else if (size == 0 || errno != EINTR) {
+                        const int status = FinishChildProcess(child_process);
+
+                        ParseChildReport(child_process.data, status, child_process.begin_time, nullptr, test_results[child_process.position]);
+                        is_done_list[child_process.position] = TEST_DONE;
+                        CountFailures(test_results[child_process.position], true);
+
+                        child_processes.erase(child_processes.begin() + index);
+                    }
+                }
+            }
+
+            const uint64_t now = TTK_GetTime();
+            if (run_deadline && now >= run_deadline) is_run_timeout = true;
+
+            for (size_t index = child_processes.size(); index-- > 0;) {
+                ChildProcess& child_process = child_processes[index];
+                const bool is_expired = child_process.timeout && now >= child_process.begin_time + child_process.timeout;
+
+                if (is_expired || is_run_timeout) {
+                    KillChildProcess(child_process, FormatTimeout(is_expired ? child_process.timeout : m_run_timeout, !is_expired), test_results[child_process.position]);
+                    is_done_list[child_process.position] = TEST_DONE;
+                    CountFailures(test_results[child_process.position], true);
+
+                    child_processes.erase(child_processes.begin() + index);
+                }
+            }
+
+            if (IsCancelled()) {
+                for (ChildProcess& child_process : child_processes) {
+                    kill(child_process.pid, SIGKILL);
+                    FinishChildProcess(child_process);
+                    is_done_list[child_process.position] = TEST_SKIPPED;
+                }
+                child_processes.clear();
+
+                for (; next_position < count; ++next_position) is_done_list[next_position] = TEST_SKIPPED;
+            }
+
+            for (; commit_position < count && is_done_list[commit_position]; ++commit_position) {
+                if (is_done_list[commit_position] == TEST_SKIPPED) continue;
+                if (!CommitDeferredTestResult(m_tests.ToTest(indices[commit_position]), test_results[commit_position])) {
+                    is_aborted = true; // abort all tests
+                    break;
+                }
+            }
+
+            if (is_run_timeout && child_processes.empty()) break;
+        }
+
+        if (is_run_timeout) PrintRunTimeout(count);
+
+        for (ChildProcess& child_process : child_processes) {
+            kill(child_process.pid, SIGKILL);
+            FinishChildProcess(child_process);
+        }
+    }
+#else
+    void ReportAssertFail(const TTK_TestResult&, unsigned, const char*, const char*, const char*) {}
+    void ReportNote(const std::string&) {}
+    void ReportBaseline(const std::string&, double) {}
+
+    void RunInChildProcesses(const std::vector<TTK_Register::SizeType>& indices, uint32_t) {
+        RunOnCurrentThread(indices);
+    }
+#endif
+
+    TTK_Output      m_output;
+
+    uint64_t        m_number_of_executed_asserts;
+    uint64_t        m_number_of_failed_asserts;
+
+    uint64_t        m_number_of_executed_tests;
+    uint64_t        m_number_of_failed_tests;
+
+    uint32_t        m_number_of_workers;
+
+    bool            m_is_process_isolation;
+    int             m_report_descriptor;    // pipe to parent process, when this is child process which executes test function
+
+    bool            m_is_print_test_time;
+    uint32_t        m_number_of_slowest_tests;
+
+    uint64_t        m_total_time;           // in nanoseconds
+
+    std::vector<TTK_TestRecord> m_test_records;
+
+    uint64_t        m_benchmark_min_sample_time;    // in nanoseconds
+    uint32_t        m_benchmark_number_of_samples;
+
+    uint64_t        m_property_number_of_cases;
+    uint64_t        m_property_max_time;            // in nanoseconds
+    uint64_t        m_property_seed;                // 0 - solved at each run
+    uint64_t        m_property_run_seed;
+
+    uint32_t        m_shard_index;
+    uint32_t        m_number_of_shards;
+    bool            m_is_shard_set;
+
+    bool            m_is_max_test_num_reached;
+    bool            m_is_static_tests_collected;    // records from linker section has been added to tests (see TTK_STATIC_REGISTRATION)
+
+    uint64_t        m_test_timeout;                 // in nanoseconds, 0 - no timeout
+    uint64_t        m_run_timeout;                  // in nanoseconds, 0 - no timeout
+    uint64_t        m_run_begin_time;
+
+    uint64_t                m_max_failed_tests;             // 0 - no limit
+    uint64_t                m_max_failed_asserts;           // 0 - no limit
+    std::atomic<uint64_t>   m_number_of_live_failed_tests;  // counted as soon as test functions finish, in any order
+    std::atomic<uint64_t>   m_number_of_live_failed_asserts;
+    std::atomic<bool>       m_is_cancelled;                 // limit of failures has been reached
+
+    bool            m_is_print_allocations;
+
+    std::string         m_baseline_file_name;           // utf-8
+    TTK_BaselineMode    m_baseline_mode;
+    TTK_BaselineMode    m_baseline_run_mode;            // solved at each run
+    TTK_BaselineStore   m_baselines;
+    bool                m_is_baselines_loaded;          // file of baselines is read at first lookup of each run
+    std::mutex          m_baseline_load_mutex;
+
+    std::string         m_result_cache_file_name;       // utf-8, empty - results are not cached
+    TTK_ResultCacheMode m_result_cache_mode;
+    TTK_ResultCacheMode m_result_cache_run_mode;        // solved at each run
+    TTK_ResultCache     m_result_cache;
+    std::string         m_binary_identity;              // taken at first run with result cache
+    bool                m_is_longest_first;
+
+    std::vector<TTK_FixtureBase*>   m_constructed_fixtures;     // in order of construction, destroyed at the end of run
+    std::mutex                      m_fixture_mutex;
+
+    std::mutex      m_commit_mutex;                 // held while result of test function is committed, so watchdog doesn't interleave with it
+    std::mutex      m_deferred_mutex;               // held while fail or note is stored by test function, so watchdog can take stored ones of stuck test function
+    bool            m_is_deferred_stopped;          // set by watchdog, then fails and notes of stuck test functions are discarded
+
+    TTK_TestResult  m_stray_test_result;    // collects asserts executed outside of test functions
+
+    std::vector<TTK_Reporter*> m_reporters;
+
+    std::vector<TTK_NameFilter> m_filters;
+    std::unique_ptr<TTK_TagFilter> m_tag_filter;   // nullptr - no filter by tags
+
+    std::vector<std::unique_ptr<TTK_CaseSet>> m_case_sets;   // cases of parameterized test functions
+
+    TTK_Register    m_tests;
+};
+
+
+//------------------------------------------------------------------------------
+
+inline TTK_Suite& TTK_ToSuite() {
+    static TTK_Suite s_suite;
+    return s_suite;
+}
+
+inline bool TTK_Run() {
+    return TTK_ToSuite().Run();
+}
+
+// Objects of fixture declared by TTK_FIXTURE. 
+template <typename Type>
+class TTK_Fixture : public TTK_FixtureBase {
+public:
+    explicit TTK_Fixture(TTK_FixtureScope scope) {
+        m_scope                 = scope;
+        m_shared_object         = nullptr;
+        m_is_registered         = false;
+    }
+
+    virtual ~TTK_Fixture() {
+        Destroy();
+    }
+
+    // Returns object for current worker (or shared object), constructing it at first call.
+    Type& Get() {
+        if (m_scope == TTK_FIXTURE_PER_RUN) {
+            Type* object = m_shared_object.load(std::memory_order_acquire);
+            if (object) return *object;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const size_t index = (m_scope == TTK_FIXTURE_PER_WORKER) ? TTK_ToWorkerIndex() : 0;
+        if (index >= m_objects.size()) m_objects.resize(index + 1);
+
+        if (!m_objects[index]) {
+            m_objects[index].reset(new Type());
+
+            if (!m_is_registered) {
+                TTK_ToSuite().AddConstructedFixture(this);
+                m_is_registered = true;
+            }
+            if (m_scope == TTK_FIXTURE_PER_RUN) m_shared_object.store(m_objects[index].get(), std::memory_order_release);
+        }
+
+        return *m_objects[index];
+    }
+
+    void Destroy() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_shared_object = nullptr;
+        while (!m_objects.empty()) m_objects.pop_back(); // objects of workers in reverse order
+        m_is_registered = false;
+    }
+
+private:
+    TTK_FixtureScope                    m_scope;
+    std::vector<std::unique_ptr<Type>>  m_objects;          // indexed by worker
+    std::atomic<Type*>                  m_shared_object;    // constructed object of TTK_FIXTURE_PER_RUN, read without lock
+    bool                                m_is_registered;    // to be destroyed at the end of run
+    std::mutex                          m_mutex;
+};
+
+inline void TTK_Clear() {
+    TTK_ToSuite().Clear();
+}
+
+inline void TTK_ReserveTests(size_t number_of_tests) {
+    TTK_ToSuite().ReserveTests(number_of_tests);
+}
+
+inline void TTK_SetOutput(FILE* output) {
+    TTK_ToSuite().SetOutput(output);
+}
+
+inline void TTK_SetOutputMode(TTK_OutputMode mode, size_t buffer_size) {
+    TTK_ToSuite().SetOutputMode(mode, buffer_size);
+}
+
+inline void TTK_AddReporter(TTK_Reporter* reporter) {
+    TTK_ToSuite().AddReporter(reporter);
+}
+
+inline void TTK_ForceOutputOrientation(int orientation) {
+    TTK_ToSuite().ForceOutputOrientation(orientation);
+}
+
+inline void TTK_SetNumberOfWorkers(uint32_t number_of_workers) {
+    TTK_ToSuite().SetNumberOfWorkers(number_of_workers);
+}
+
+inline void TTK_SetProcessIsolation(bool is_process_isolation) {
+    TTK_ToSuite().SetProcessIsolation(is_process_isolation);
+}
+
+inline void TTK_SetShard(uint32_t shard_index, uint32_t number_of_shards) {
+    TTK_ToSuite().SetShard(shard_index, number_of_shards);
+}
+
+inline bool TTK_AddFilter(const char* pattern, bool is_exclude, bool is_regex) {
+    return TTK_ToSuite().AddFilter(pattern, is_exclude, is_regex);
+}
+
+inline void TTK_ClearFilters() {
+    TTK_ToSuite().ClearFilters();
+}
+
+inline bool TTK_SetTagFilter(const char* expression) {
+    return TTK_ToSuite().SetTagFilter(expression);
+}
+
+inline void TTK_SetTimeReport(bool is_print_test_time, uint32_t number_of_slowest_tests) {
+    TTK_ToSuite().SetTimeReport(is_print_test_time, number_of_slowest_tests);
+}
+
+inline const std::vector<TTK_TestRecord>& TTK_GetTestRecords() {
+    return TTK_ToSuite().GetTestRecords();
+}
+
+inline void TTK_SetBaseline(const char* file_name_utf8, TTK_BaselineMode mode) {
+    TTK_ToSuite().SetBaseline(file_name_utf8, mode);
+}
+
+inline void TTK_SetResultCache(const char* file_name_utf8, TTK_ResultCacheMode mode) {
+    TTK_ToSuite().SetResultCache(file_name_utf8, mode);
+}
+
+inline void TTK_SetLongestFirst(bool is_longest_first) {
+    TTK_ToSuite().SetLongestFirst(is_longest_first);
+}
+
+inline void TTK_SetAllocationReport(bool is_print_allocations) {
+    TTK_ToSuite().SetAllocationReport(is_print_allocations);
+}
+
+inline void TTK_SetMaxFailures(uint64_t max_failed_tests, uint64_t max_failed_asserts) {
+    TTK_ToSuite().SetMaxFailures(max_failed_tests, max_failed_asserts);
+}
+
+inline bool TTK_IsCancelled() {
+    return TTK_ToSuite().IsCancelled();
+}
+
+inline void TTK_SetTimeout(uint64_t test_timeout, uint64_t run_timeout) {
+    TTK_ToSuite().SetTimeout(test_timeout, run_timeout);
+}
+
+inline uint64_t TTK_GetTotalTime() {
+    return TTK_ToSuite().GetTotalTime();
+}
+
+inline void TTK_SetBenchmarkConfig(uint64_t min_sample_time, uint32_t number_of_samples) {
+    TTK_ToSuite().SetBenchmarkConfig(min_sample_time, number_of_samples);
+}
+
+inline void TTK_SetPropertyConfig(uint64_t number_of_cases, uint64_t max_time, uint64_t seed) {
+    TTK_ToSuite().SetPropertyConfig(number_of_cases, max_time, seed);
+}
+
+//------------------------------------------------------------------------------
+
+// First failed assertion of single check of property.
+struct TTK_PropertyProbe {
+    uint64_t        number_of_fails;
+    unsigned        line;
+    const char*     condition;
+    const char*     file_name_utf8;
+    std::string     message;
+    bool            is_message;
+};
+
+// Probe of property checked on this thread. If isn't nullptr, then failed assertions are recorded in it, instead of being communicated.
+inline TTK_PropertyProbe*& TTK_ToPropertyProbe() {
+    static thread_local TTK_PropertyProbe* s_property_probe = nullptr;
+    return s_property_probe;
+}
+
+inline void TTK_RecordPropertyFail(unsigned line, const char* condition, const char* file_name_utf8, const char* message) {
+    TTK_PropertyProbe& probe = *TTK_ToPropertyProbe();
+
+    if (probe.number_of_fails++ == 0) {
+        probe.line              = line;
+        probe.condition         = condition;
+        probe.file_name_utf8    = file_name_utf8;
+        probe.message           = message ? message : "";
+        probe.is_message        = message != nullptr;
+    }
+}
+
+// Failure paths of assertions. Kept out of line, so code of passing assertion stays minimal.
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+inline void TTK_AssertFail(unsigned line, const char* condition, const char* file_name_utf8, const char* message) {
+    if (TTK_ToPropertyProbe()) {
+        TTK_RecordPropertyFail(line, condition, file_name_utf8, message);
+        return;
+    }
+    TTK_ToSuite().CommunicateAssertFail(line, condition, file_name_utf8, message);
+    TTK_ToSuite().RequestAbort();
+}
+
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+inline void TTK_AssertFail(unsigned line, const char* condition, const char* file_name_utf8, const std::string& message) {
+    TTK_AssertFail(line, condition, file_name_utf8, message.c_str());
+}
+
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+inline void TTK_ExpectFail(unsigned line, const char* condition, const char* file_name_utf8, const char* message) {
+    if (TTK_ToPropertyProbe()) {
+        TTK_RecordPropertyFail(line, condition, file_name_utf8, message);
+        return;
+    }
+    TTK_ToSuite().CommunicateAssertFail(line, condition, file_name_utf8, message);
+}
+
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+inline void TTK_ExpectFail(unsigned line, const char* condition, const char* file_name_utf8, const std::string& message) {
+    TTK_ExpectFail(line, condition, file_name_utf8, message.c_str());
+}
+
+// Text of fixed capacity, kept on stack. Text, which doesn't fit, is truncated. Used for formatting values of failed comparisons.
+class TTK_TextBuffer {
+public:
+    enum { CAPACITY = 512 };
+
+    TTK_TextBuffer() {
+        m_text[0]   = '\0';
+        m_length    = 0;
+    }
+
+    virtual ~TTK_TextBuffer() {}
+
+    void Append(const char* text, size_t length) {
+        const size_t free_length = CAPACITY - 1 - m_length;
+        if (length > free_length) length = free_length;
+
+        memcpy(m_text + m_length, text, length);
+        m_length += length;
+        m_text[m_length] = '\0';
+    }
+
+    void Append(const char* text) {
+        Append(text, strlen(text));
+    }
+
+    void AppendFormat(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        const int length = vsnprintf(m_text + m_length, CAPACITY - m_length, format, args);
+        va_end(args);
+
+        if (length > 0) m_length = std::min<size_t>(m_length + size_t(length), CAPACITY - 1);
+    }
+
+    const char* Get() const {
+        return m_text;
+    }
+
+    size_t GetLength() const {
+        return m_length;
+    }
+
+private:
+    char    m_text[CAPACITY];
+    size_t  m_length;
+};
+
+// Appends text in quotes, with control characters escaped. Text longer than 128 characters is truncated, and ended with '...'.
+inline void TTK_AppendQuotedText(TTK_TextBuffer& buffer, const char* text, size_t length) {
+    enum { MAX_LENGTH = 128 };
+
+    buffer.Append("\"");
+    for (size_t index = 0; index < length && index < MAX_LENGTH; ++index) {
+        const char character = text[index];
+        switch (character) {
+        case '\n':  buffer.Append("\\n");  break;
+        case '\r':  buffer.Append("\\r");  break;
+        case '\t':  buffer.Append("\\t");  break;
+        case '\"':  buffer.Append("\\\""); break;
+        case '\\':  buffer.Append("\\\\"); break;
+        default:
+            if ((unsigned char)character < 0x20) {
+                buffer.AppendFormat("\\x%02X", (unsigned)(unsigned char)character);
+            } else {
+                buffer.Append(&character, 1);
+            }
+        }
+    }
+    buffer.Append(length > MAX_LENGTH ? "\"..." : "\"");
+}
+
+inline void TTK_FormatValue(TTK_TextBuffer& buffer, bool value) {
+    buffer.Append(value ? "true" : "false");
+}
+
+inline void TTK_FormatValue(TTK_TextBuffer& buffer, char value) {
+    if ((unsigned char)value < 0x20 || value == '\'' || value == '\\') {
+        buffer.AppendFormat("%d", (int)value);
+    } else {
+        buffer.AppendFormat("'%c'", value);
+    }
+}
+
+inline void TTK_FormatValue(TTK_TextBuffer& buffer, std::nullptr_t) {
+    buffer.Append("nullptr");
+}
+
+inline void TTK_FormatValue(TTK_TextBuffer& buffer, const std::string& value) {
+    TTK_AppendQuotedText(buffer, value.c_str(), value.length());
+}
+
+template <size_t LENGTH>
+void TTK_FormatValue(TTK_TextBuffer& buffer, const char (&value)[LENGTH]) {
+    TTK_AppendQuotedText(buffer, value, strnlen(value, LENGTH));
+}
+
+enum TTK_ValueKind {
+    TTK_VALUE_KIND_OTHER,
+    TTK_VALUE_KIND_SIGNED_INTEGER,
+    TTK_VALUE_KIND_UNSIGNED_INTEGER,
+    TTK_VALUE_KIND_FLOATING_POINT,
+    TTK_VALUE_KIND_ENUM,
+    TTK_VALUE_KIND_C_STRING,
+    TTK_VALUE_KIND_POINTER,
+};
+
+template <typename Type>
+struct TTK_ToValueKind {
+    typedef typename std::remove_cv<typename std::remove_pointer<Type>::type>::type PointeeType;
+
+    static constexpr TTK_ValueKind VALUE = 
+        std::is_integral<Type>::value       ? (std::is_signed<Type>::value ? TTK_VALUE_KIND_SIGNED_INTEGER : TTK_VALUE_KIND_UNSIGNED_INTEGER) :
+        std::is_floating_point<Type>::value ? TTK_VALUE_KIND_FLOATING_POINT :
+        std::is_enum<Type>::value           ? TTK_VALUE_KIND_ENUM :
+        std::is_pointer<Type>::value        ? (std::is_same<PointeeType, char>::value ? TTK_VALUE_KIND_C_STRING : TTK_VALUE_KIND_POINTER) :
+                                              TTK_VALUE_KIND_OTHER;
+};
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_SIGNED_INTEGER>) {
+    buffer.AppendFormat("%lld", (long long)value);
+}
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_UNSIGNED_INTEGER>) {
+    buffer.AppendFormat("%llu", (unsigned long long)value);
+}
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_FLOATING_POINT>) {
+    // Number of significant digits is enough to distinguish any two different values.
+    if (sizeof(Type) <= sizeof(double)) {
+        buffer.AppendFormat("%.*g", std::numeric_limits<Type>::max_digits10, (double)value);
+    } else {
+        buffer.AppendFormat("%.*Lg", std::numeric_limits<Type>::max_digits10, (long double)value);
+    }
+}
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_ENUM>) {
+    typedef typename std::underlying_type<Type>::type UnderlyingType;
+
+    if (std::is_signed<UnderlyingType>::value) {
+        buffer.AppendFormat("%lld", (long long)value);
+    } else {
+        buffer.AppendFormat("%llu", (unsigned long long)value);
+    }
+}
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_C_STRING>) {
+    if (value) {
+        TTK_AppendQuotedText(buffer, value, strlen(value));
+    } else {
+        buffer.Append("nullptr");
+    }
+}
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_POINTER>) {
+    if (value) {
+        buffer.AppendFormat("%p", (const void*)value);
+    } else {
+        buffer.Append("nullptr");
+    }
+}
+
+template <typename Type>
+void TTK_FormatValueOfKind(TTK_TextBuffer& buffer, const Type& value, std::integral_constant<TTK_ValueKind, TTK_VALUE_KIND_OTHER>) {
+    enum { MAX_NUMBER_OF_BYTES = 16 };
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+
+    buffer.AppendFormat("%llu-byte object <", (unsigned long long)sizeof(Type));
+    for (size_t index = 0; index < sizeof(Type) && index < MAX_NUMBER_OF_BYTES; ++index) {
+        buffer.AppendFormat(index ? " %02X" : "%02X", (unsigned)bytes[index]);
+    }
+    buffer.Append(sizeof(Type) > MAX_NUMBER_OF_BYTES ? " ...>" : ">");
+}
+
+template <typename Type>
+void TTK_FormatValue(TTK_TextBuffer& buffer, const Type& value) {
+    TTK_FormatValueOfKind(buffer, value, std::integral_constant<TTK_ValueKind, TTK_ToValueKind<Type>::VALUE>());
+}
+
+// Failure path of comparison assertions. Values are formatted into buffer on stack.
+template <typename LeftType, typename RightType>
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+void TTK_CompareFail(bool is_assert, unsigned line, const char* condition, const char* file_name_utf8, const LeftType& left, const RightType& right) {
+    TTK_TextBuffer message;
+
+    message.Append("left: ");
+    TTK_FormatValue(message, left);
+    message.Append(", right: ");
+    TTK_FormatValue(message, right);
+
+    if (is_assert) {
+        TTK_AssertFail(line, condition, file_name_utf8, message.Get());
+    } else {
+        TTK_ExpectFail(line, condition, file_name_utf8, message.Get());
+    }
+}
+
+inline uint32_t TTK_CountBits(uint32_t value) {
+#if defined(__GNUC__)
+    return uint32_t(__builtin_popcount(value));
+#else
+    uint32_t number_of_bits = 0;
+    for (; value; value &= value - 1) ++number_of_bits;
+    return number_of_bits;
+#endif
+}
+
+// Compares memory by C library, which uses the widest vector instructions available.
+inline bool TTK_IsMemoryEqual(const void* left, const void* right, size_t size) {
+    return size == 0 || memcmp(left, right, size) == 0;
+}
+
+// Finds first mismatched byte (size, if there is none). Returns number of mismatched bytes.
+inline size_t TTK_CountMemoryMismatches(const uint8_t* left, const uint8_t* right, size_t size, size_t& first_mismatch) {
+    size_t number_of_mismatches = 0;
+    size_t index                = 0;
+
+    first_mismatch = size;
+
+#if defined(TTK_SSE2_AVAILABLE)
+    for (; index + 16 <= size; index += 16) {
+        const __m128i left_bytes    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + index));
+        const __m128i right_bytes   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + index));
+        const uint32_t mismatches   = ~uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(left_bytes, right_bytes))) & 0xFFFF;
+
+        if (mismatches) {
+            if (number_of_mismatches == 0) {
+                first_mismatch = index;
+                while (left[first_mismatch] == right[first_mismatch]) ++first_mismatch;
+            }
+            number_of_mismatches += TTK_CountBits(mismatches);
+        }
+    }
+#endif
+
+    for (; index < size; ++index) {
+        if (left[index] != right[index]) {
+            if (number_of_mismatches++ == 0) first_mismatch = index;
+        }
+    }
+    return number_of_mismatches;
+}
+
+// Failure path of TTK_ASSERT_MEM_EQ and TTK_EXPECT_MEM_EQ.
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+inline void TTK_MemoryFail(bool is_assert, unsigned line, const char* condition, const char* file_name_utf8, const void* left, const void* right, size_t size) {
+    const uint8_t* left_bytes   = static_cast<const uint8_t*>(left);
+    const uint8_t* right_bytes  = static_cast<const uint8_t*>(right);
+
+    size_t first_mismatch = 0;
+    const size_t number_of_mismatches = TTK_CountMemoryMismatches(left_bytes, right_bytes, size, first_mismatch);
+
+    // Window of 16 bytes, starting slightly before first mismatch.
+    const size_t begin  = first_mismatch >= 4 ? first_mismatch - 4 : 0;
+    const size_t end    = std::min<size_t>(size, begin + 16);
+
+    TTK_TextBuffer message;
+    message.AppendFormat("size: %llu, first mismatch at: %llu, number of mismatches: %llu", 
+        (unsigned long long)size, (unsigned long long)first_mismatch, (unsigned long long)number_of_mismatches);
+
+    const uint8_t* const    bytes_list[]    = {left_bytes, right_bytes};
+    const char* const       names[]         = {"left", "right"};
+
+    for (size_t side = 0; side < 2; ++side) {
+        message.AppendFormat(", %s[%llu..%llu]:", names[side], (unsigned long long)begin, (unsigned long long)end);
+        for (size_t index = begin; index < end; ++index) {
+            message.AppendFormat(" %02X", (unsigned)bytes_list[side][index]);
+        }
+    }
+
+    if (is_assert) {
+        TTK_AssertFail(line, condition, file_name_utf8, message.Get());
+    } else {
+        TTK_ExpectFail(line, condition, file_name_utf8, message.Get());
+    }
+}
+
+template <typename Type, size_t LENGTH>
+const Type* TTK_GetRangeData(const Type (&range)[LENGTH]) {
+    return range;
+}
+
+template <typename Range>
+auto TTK_GetRangeData(const Range& range) -> decltype(range.data()) {
+    return range.data();
+}
+
+template <typename Type, size_t LENGTH>
+size_t TTK_GetRangeSize(const Type (&)[LENGTH]) {
+    return LENGTH;
+}
+
+template <typename Range>
+auto TTK_GetRangeSize(const Range& range) -> decltype(size_t(range.size())) {
+    return size_t(range.size());
+}
+
+template <typename Range>
+struct TTK_ToRangeElement {
+    typedef typename std::decay<decltype(*std::begin(std::declval<const Range&>()))>::type Type;
+};
+
+// Range is contiguous, when it's an array or has data() and size().
+template <typename Range, typename = void>
+struct TTK_IsContiguousRange {
+    static constexpr bool VALUE = false;
+};
+
+template <typename Range>
+struct TTK_IsContiguousRange<Range, decltype((void)TTK_GetRangeData(std::declval<const Range&>()), (void)TTK_GetRangeSize(std::declval<const Range&>()))> {
+    static constexpr bool VALUE = true;
+};
+
+// Ranges can be compared as memory, when both are contiguous and have elements of the same type, 
+// which are equal only if their bytes are equal (integers, enums and pointers).
+template <typename LeftRange, typename RightRange>
+struct TTK_IsBitwiseComparableRanges {
+    typedef typename TTK_ToRangeElement<LeftRange>::Type    LeftElement;
+    typedef typename TTK_ToRangeElement<RightRange>::Type   RightElement;
+
+    static constexpr bool VALUE = 
+        TTK_IsContiguousRange<LeftRange>::VALUE && TTK_IsContiguousRange<RightRange>::VALUE && std::is_same<LeftElement, RightElement>::value && 
+        (std::is_integral<LeftElement>::value || std::is_enum<LeftElement>::value || std::is_pointer<LeftElement>::value);
+};
+
+template <typename LeftRange, typename RightRange>
+bool TTK_IsRangeEqualOf(const LeftRange& left, const RightRange& right, std::true_type) {
+    typedef typename TTK_ToRangeElement<LeftRange>::Type Element;
+
+    const size_t size = TTK_GetRangeSize(left);
+    return size == TTK_GetRangeSize(right) && TTK_IsMemoryEqual(TTK_GetRangeData(left), TTK_GetRangeData(right), size * sizeof(Element));
+}
+
+template <typename LeftRange, typename RightRange>
+bool TTK_IsRangeEqualOf(const LeftRange& left, const RightRange& right, std::false_type) {
+    auto left_iterator  = std::begin(left);
+    auto right_iterator = std::begin(right);
+    const auto left_end     = std::end(left);
+    const auto right_end    = std::end(right);
+
+    for (; left_iterator != left_end && right_iterator != right_end; ++left_iterator, ++right_iterator) {
+        if (!(*left_iterator == *right_iterator)) return false;
+    }
+    return left_iterator == left_end && right_iterator == right_end;
+}
+
+template <typename LeftRange, typename RightRange>
+bool TTK_IsRangeEqual(const LeftRange& left, const RightRange& right) {
+    return TTK_IsRangeEqualOf(left, right, std::integral_constant<bool, TTK_IsBitwiseComparableRanges<LeftRange, RightRange>::VALUE>());
+}
+
+// Appends elements of range from begin to end (or to end of range).
+template <typename Range>
+void TTK_AppendRangeWindow(TTK_TextBuffer& buffer, const Range& range, size_t begin, size_t end) {
+    buffer.Append(":");
+
+    size_t index = 0;
+    for (auto iterator = std::begin(range); iterator != std::end(range) && index < end; ++iterator, ++index) {
+        if (index >= begin) {
+            buffer.Append(index > begin ? ", " : " ");
+            TTK_FormatValue(buffer, *iterator);
+        }
+    }
+}
+
+// Failure path of TTK_ASSERT_RANGE_EQ and TTK_EXPECT_RANGE_EQ.
+template <typename LeftRange, typename RightRange>
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+void TTK_RangeFail(bool is_assert, unsigned line, const char* condition, const char* file_name_utf8, const LeftRange& left, const RightRange& right) {
+    auto left_iterator  = std::begin(left);
+    auto right_iterator = std::begin(right);
+
+    size_t number_of_mismatches = 0;
+    size_t first_mismatch       = 0;
+    size_t index                = 0;
+
+    for (; left_iterator != std::end(left) && right_iterator != std::end(right); ++left_iterator, ++right_iterator, ++index) {
+        if (!(*left_iterator == *right_iterator)) {
+            if (number_of_mismatches++ == 0) first_mismatch = index;
+        }
+    }
+
+    const size_t left_size  = index + size_t(std::distance(left_iterator, std::end(left)));
+    const size_t right_size = index + size_t(std::distance(right_iterator, std::end(right)));
+
+    // Elements beyond shorter range are mismatched.
+    if (number_of_mismatches == 0) first_mismatch = index;
+    number_of_mismatches += std::max(left_size, right_size) - index;
+
+    // Window of 5 elements, starting slightly before first mismatch.
+    const size_t begin  = first_mismatch >= 2 ? first_mismatch - 2 : 0;
+    const size_t end    = begin + 5;
+
+    TTK_TextBuffer message;
+    message.AppendFormat("left size: %llu, right size: %llu, first mismatch at: %llu, number of mismatches: %llu", 
+        (unsigned long long)left_size, (unsigned long long)right_size, (unsigned long long)first_mismatch, (unsigned long long)number_of_mismatches);
+
+    message.AppendFormat(", left[%llu..%llu]", (unsigned long long)std::min(begin, left_size), (unsigned long long)std::min(end, left_size));
+    TTK_AppendRangeWindow(message, left, begin, end);
+    message.AppendFormat(", right[%llu..%llu]", (unsigned long long)std::min(begin, right_size), (unsigned long long)std::min(end, right_size));
+    TTK_AppendRangeWindow(message, right, begin, end);
+
+    if (is_assert) {
+        TTK_AssertFail(line, condition, file_name_utf8, message.Get());
+    } else {
+        TTK_ExpectFail(line, condition, file_name_utf8, message.Get());
+    }
+}
+
+enum TTK_ArrayErrorKind {
+    TTK_ARRAY_ERROR_RELATIVE,
+    TTK_ARRAY_ERROR_ULP,
+};
+
+// Returns |actual - expected| / max(min_magnitude, |expected|). Computed in precision of Type, the same as by SSE2 kernels.
+template <typename Type>
+Type TTK_GetRelativeError(Type actual, Type expected, Type min_magnitude) {
+    if (actual == expected || (actual != actual && expected != expected)) return 0;
+
+    const Type error = Type(fabs(actual - expected)) / std::max(min_magnitude, Type(fabs(expected)));
+    return (error == error) ? error : std::numeric_limits<Type>::infinity();
+}
+
+// Maps number to integer, which order is the same as order of numbers. 0 and -0 are mapped to the same integer.
+inline int64_t TTK_ToOrderedInteger(float value) {
+    int32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >= 0) ? bits : int64_t(INT32_MIN) - bits;
+}
+
+inline int64_t TTK_ToOrderedInteger(double value) {
+    int64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >= 0) ? bits : INT64_MIN - bits;
+}
+
+// Returns number of representable numbers between actual and expected.
+template <typename Type>
+double TTK_GetULPError(Type actual, Type expected) {
+    if (actual == expected || (actual != actual && expected != expected)) return 0;
+
+    const Type max_value = std::numeric_limits<Type>::max();
+    if (actual != actual || expected != expected || fabs(actual) > max_value || fabs(expected) > max_value) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // Subtraction of unsigned integers, so it can't overflow.
+    const uint64_t actual_integer   = uint64_t(TTK_ToOrderedInteger(actual));
+    const uint64_t expected_integer = uint64_t(TTK_ToOrderedInteger(expected));
+    return double(TTK_ToOrderedInteger(actual) >= TTK_ToOrderedInteger(expected) ? actual_integer - expected_integer : expected_integer - actual_integer);
+}
+
+template <typename Type>
+double TTK_GetArrayError(Type actual, Type expected, double min_magnitude, TTK_ArrayErrorKind kind) {
+    return (kind == TTK_ARRAY_ERROR_ULP) ? TTK_GetULPError(actual, expected) : double(TTK_GetRelativeError(actual, expected, Type(min_magnitude)));
+}
+
+// Maximal error and sum of finite errors of elements.
+struct TTK_ArrayErrors {
+    double max_error;
+    double sum_of_finite_errors;
+};
+
+inline void TTK_AddArrayError(TTK_ArrayErrors& errors, double error) {
+    errors.max_error = std::max(errors.max_error, error);
+    if (error != std::numeric_limits<double>::infinity()) errors.sum_of_finite_errors += error;
+}
+
+#if defined(TTK_SSE2_AVAILABLE)
+
+// Kernels measure elements by packs and return number of measured elements. Remaining elements are measured by TTK_MeasureArrayErrors.
+
+inline double TTK_GetMaxOfLanes(__m128d values) {
+    return std::max(_mm_cvtsd_f64(values), _mm_cvtsd_f64(_mm_unpackhi_pd(values, values)));
+}
+
+inline double TTK_GetSumOfLanes(__m128d values) {
+    return _mm_cvtsd_f64(values) + _mm_cvtsd_f64(_mm_unpackhi_pd(values, values));
+}
+
+inline size_t TTK_MeasureRelativeErrorsSSE2(const float* actual, const float* expected, size_t size, double min_magnitude, TTK_ArrayErrors& errors) {
+    const __m128 min_magnitudes = _mm_set1_ps(float(min_magnitude));
+    const __m128 infinity       = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    const __m128 absolute_mask  = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    __m128  max_errors  = _mm_setzero_ps();
+    __m128d sums        = _mm_setzero_pd();
+
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        const __m128 actual_values      = _mm_loadu_ps(actual + index);
+        const __m128 expected_values    = _mm_loadu_ps(expected + index);
+
+        const __m128 difference = _mm_and_ps(_mm_sub_ps(actual_values, expected_values), absolute_mask);
+        const __m128 scale      = _mm_max_ps(min_magnitudes, _mm_and_ps(expected_values, absolute_mask));
+        const __m128 is_same    = _mm_or_ps(_mm_cmpeq_ps(actual_values, expected_values), 
+                                            _mm_and_ps(_mm_cmpunord_ps(actual_values, actual_values), _mm_cmpunord_ps(expected_values, expected_values)));
+
+        __m128 error = _mm_andnot_ps(is_same, _mm_div_ps(difference, scale));
+        const __m128 is_invalid = _mm_cmpunord_ps(error, error);
+        error = _mm_or_ps(_mm_and_ps(is_invalid, infinity), _mm_andnot_ps(is_invalid, error));
+
+        max_errors = _mm_max_ps(max_errors, error);
+
+        const __m128 finite_error = _mm_andnot_ps(_mm_cmpeq_ps(error, infinity), error);
+        sums = _mm_add_pd(sums, _mm_cvtps_pd(finite_error));
+        sums = _mm_add_pd(sums, _mm_cvtps_pd(_mm_movehl_ps(finite_error, finite_error)));
+    }
+
+    const __m128 max_errors_high = _mm_movehl_ps(max_errors, max_errors);
+    errors.max_error = std::max(errors.max_error, TTK_GetMaxOfLanes(_mm_max_pd(_mm_cvtps_pd(max_errors), _mm_cvtps_pd(max_errors_high))));
+    errors.sum_of_finite_errors += TTK_GetSumOfLanes(sums);
+    return index;
+}
+
+inline size_t TTK_MeasureRelativeErrorsSSE2(const double* actual, const double* expected, size_t size, double min_magnitude, TTK_ArrayErrors& errors) {
+    const __m128d min_magnitudes = _mm_set1_pd(min_magnitude);
+    const __m128d infinity      = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    const __m128d absolute_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+    __m128d max_errors  = _mm_setzero_pd();
+    __m128d sums        = _mm_setzero_pd();
+
+    size_t index = 0;
+    for (; index + 2 <= size; index += 2) {
+        const __m128d actual_values     = _mm_loadu_pd(actual + index);
+        const __m128d expected_values   = _mm_loadu_pd(expected + index);
+
+        const __m128d difference    = _mm_and_pd(_mm_sub_pd(actual_values, expected_values), absolute_mask);
+        const __m128d scale         = _mm_max_pd(min_magnitudes, _mm_and_pd(expected_values, absolute_mask));
+        const __m128d is_same       = _mm_or_pd(_mm_cmpeq_pd(actual_values, expected_values), 
+                                                _mm_and_pd(_mm_cmpunord_pd(actual_values, actual_values), _mm_cmpunord_pd(expected_values, expected_values)));
+
+        __m128d error = _mm_andnot_pd(is_same, _mm_div_pd(difference, scale));
+        const __m128d is_invalid = _mm_cmpunord_pd(error, error);
+        error = _mm_or_pd(_mm_and_pd(is_invalid, infinity), _mm_andnot_pd(is_invalid, error));
+
+        max_errors  = _mm_max_pd(max_errors, error);
+        sums        = _mm_add_pd(sums, _mm_andnot_pd(_mm_cmpeq_pd(error, infinity), error));
+    }
+
+    errors.max_error = std::max(errors.max_error, TTK_GetMaxOfLanes(max_errors));
+    errors.sum_of_finite_errors += TTK_GetSumOfLanes(sums);
+    return index;
+}
+
+// Distances of floats are computed on doubles, which represent exactly any difference of two ordered integers of floats.
+inline size_t TTK_MeasureULPErrorsSSE2(const float* actual, const float* expected, size_t size, TTK_ArrayErrors& errors) {
+    const __m128    max_value       = _mm_set1_ps(std::numeric_limits<float>::max());
+    const __m128    absolute_mask   = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128i   min_integer     = _mm_set1_epi32(INT32_MIN);
+    const __m128d   infinity        = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    const __m128d   absolute_mask_d = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+    __m128d max_errors  = _mm_setzero_pd();
+    __m128d sums        = _mm_setzero_pd();
+
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        const __m128 actual_values      = _mm_loadu_ps(actual + index);
+        const __m128 expected_values    = _mm_loadu_ps(expected + index);
+
+        const __m128 is_same    = _mm_or_ps(_mm_cmpeq_ps(actual_values, expected_values), 
+                                            _mm_and_ps(_mm_cmpunord_ps(actual_values, actual_values), _mm_cmpunord_ps(expected_values, expected_values)));
+        // NaN compares as not lower or equal, so it's special too.
+        const __m128 is_special = _mm_or_ps(_mm_cmpnle_ps(_mm_and_ps(actual_values, absolute_mask), max_value), 
+                                            _mm_cmpnle_ps(_mm_and_ps(expected_values, absolute_mask), max_value));
+
+        const __m128i actual_bits       = _mm_castps_si128(actual_values);
+        const __m128i expected_bits     = _mm_castps_si128(expected_values);
+        const __m128i actual_sign       = _mm_srai_epi32(actual_bits, 31);
+        const __m128i expected_sign     = _mm_srai_epi32(expected_bits, 31);
+        const __m128i actual_integers   = _mm_or_si128(_mm_and_si128(actual_sign, _mm_sub_epi32(min_integer, actual_bits)), _mm_andnot_si128(actual_sign, actual_bits));
+        const __m128i expected_integers = _mm_or_si128(_mm_and_si128(expected_sign, _mm_sub_epi32(min_integer, expected_bits)), _mm_andnot_si128(expected_sign, expected_bits));
+
+        const __m128i is_same_bits      = _mm_castps_si128(is_same);
+        const __m128i is_special_bits   = _mm_castps_si128(is_special);
+
+        for (int half = 0; half < 2; ++half) {
+            const __m128i actual_half   = half ? _mm_shuffle_epi32(actual_integers, _MM_SHUFFLE(1, 0, 3, 2)) : actual_integers;
+            const __m128i expected_half = half ? _mm_shuffle_epi32(expected_integers, _MM_SHUFFLE(1, 0, 3, 2)) : expected_integers;
+            const __m128d is_same_half      = _mm_castsi128_pd(half ? _mm_unpackhi_epi32(is_same_bits, is_same_bits) : _mm_unpacklo_epi32(is_same_bits, is_same_bits));
+            const __m128d is_special_half   = _mm_castsi128_pd(half ? _mm_unpackhi_epi32(is_special_bits, is_special_bits) : _mm_unpacklo_epi32(is_special_bits, is_special_bits));
+
+            const __m128d distance  = _mm_and_pd(_mm_sub_pd(_mm_cvtepi32_pd(actual_half), _mm_cvtepi32_pd(expected_half)), absolute_mask_d);
+            const __m128d error     = _mm_andnot_pd(is_same_half, _mm_or_pd(_mm_and_pd(is_special_half, infinity), _mm_andnot_pd(is_special_half, distance)));
+
+            max_errors  = _mm_max_pd(max_errors, error);
+            sums        = _mm_add_pd(sums, _mm_andnot_pd(_mm_cmpeq_pd(error, infinity), error));
+        }
+    }
+
+    errors.max_error = std::max(errors.max_error, TTK_GetMaxOfLanes(max_errors));
+    errors.sum_of_finite_errors += TTK_GetSumOfLanes(sums);
+    return index;
+}
+
+// Ordered integers of doubles with the same sign are subtracted, and with different signs their magnitudes are added, 
+// so distance is exact in unsigned 64-bit integer. It's converted to double from halves: high * 2^32 + low, each made exact by magic number, 
+// so sum is rounded once, the same as by conversion of unsigned integer.
+inline size_t TTK_MeasureULPErrorsSSE2(const double* actual, const double* expected, size_t size, TTK_ArrayErrors& errors) {
+    const __m128d   max_value       = _mm_set1_pd(std::numeric_limits<double>::max());
+    const __m128i   absolute_mask   = _mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL);
+    const __m128i   low_mask        = _mm_set1_epi64x(0x00000000FFFFFFFFLL);
+    const __m128i   low_magic       = _mm_set1_epi64x(0x4330000000000000LL);   // 2^52
+    const __m128i   high_magic      = _mm_set1_epi64x(0x4530000000000000LL);   // 2^84
+    const __m128d   magic_sum       = _mm_set1_pd(19342813118337666422669312.0);    // 2^84 + 2^52
+    const __m128d   infinity        = _mm_set1_pd(std::numeric_limits<double>::infinity());
+
+    __m128d max_errors  = _mm_setzero_pd();
+    __m128d sums        = _mm_setzero_pd();
+
+    size_t index = 0;
+    for (; index + 2 <= size; index += 2) {
+        const __m128d actual_values     = _mm_loadu_pd(actual + index);
+        const __m128d expected_values   = _mm_loadu_pd(expected + index);
+
+        const __m128d is_same       = _mm_or_pd(_mm_cmpeq_pd(actual_values, expected_values), 
+                                                _mm_and_pd(_mm_cmpunord_pd(actual_values, actual_values), _mm_cmpunord_pd(expected_values, expected_values)));
+        // NaN compares as not lower or equal, so it's special too.
+        const __m128d is_special    = _mm_or_pd(_mm_cmpnle_pd(_mm_castsi128_pd(_mm_and_si128(_mm_castpd_si128(actual_values), absolute_mask)), max_value), 
+                                                _mm_cmpnle_pd(_mm_castsi128_pd(_mm_and_si128(_mm_castpd_si128(expected_values), absolute_mask)), max_value));
+
+        const __m128i actual_bits       = _mm_castpd_si128(actual_values);
+        const __m128i expected_bits     = _mm_castpd_si128(expected_values);
+        const __m128i actual_magnitude  = _mm_and_si128(actual_bits, absolute_mask);
+        const __m128i expected_magnitude = _mm_and_si128(expected_bits, absolute_mask);
+
+        // Sign of high dword is broadcasted to whole 64-bit lane.
+        const __m128i is_sign_different = _mm_shuffle_epi32(_mm_srai_epi32(_mm_xor_si128(actual_bits, expected_bits), 31), _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128i difference        = _mm_sub_epi64(actual_magnitude, expected_magnitude);
+        const __m128i difference_sign   = _mm_shuffle_epi32(_mm_srai_epi32(difference, 31), _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128i absolute_difference = _mm_sub_epi64(_mm_xor_si128(difference, difference_sign), difference_sign);
+        const __m128i distance          = _mm_or_si128(_mm_and_si128(is_sign_different, _mm_add_epi64(actual_magnitude, expected_magnitude)), 
+                                                       _mm_andnot_si128(is_sign_different, absolute_difference));
+
+        const __m128d low       = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(distance, low_mask), low_magic));
+        const __m128d high      = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(distance, 32), high_magic));
+        const __m128d distance_d = _mm_add_pd(_mm_sub_pd(high, magic_sum), low);
+
+        const __m128d error     = _mm_andnot_pd(is_same, _mm_or_pd(_mm_and_pd(is_special, infinity), _mm_andnot_pd(is_special, distance_d)));
+
+        max_errors  = _mm_max_pd(max_errors, error);
+        sums        = _mm_add_pd(sums, _mm_andnot_pd(_mm_cmpeq_pd(error, infinity), error));
+    }
+
+    errors.max_error = std::max(errors.max_error, TTK_GetMaxOfLanes(max_errors));
+    errors.sum_of_finite_errors += TTK_GetSumOfLanes(sums);
+    return index;
+}
+
+#endif // TTK_SSE2_AVAILABLE
+
+template <typename Type>
+TTK_ArrayErrors TTK_MeasureArrayErrors(const Type* actual, const Type* expected, size_t size, double min_magnitude, TTK_ArrayErrorKind kind) {
+    TTK_ArrayErrors errors = {0, 0};
+
+    size_t index = 0;
+#if defined(TTK_SSE2_AVAILABLE)
+    index = (kind == TTK_ARRAY_ERROR_ULP) ? TTK_MeasureULPErrorsSSE2(actual, expected, size, errors) : TTK_MeasureRelativeErrorsSSE2(actual, expected, size, min_magnitude, errors);
+#endif
+
+    for (; index < size; ++index) {
+        TTK_AddArrayError(errors, TTK_GetArrayError(actual[index], expected[index], min_magnitude, kind));
+    }
+    return errors;
+}
+
+template <typename Type>
+bool TTK_IsArrayNear(const Type* actual, const Type* expected, size_t size, double tolerance, double min_magnitude, TTK_ArrayErrorKind kind) {
+    static_assert(std::is_same<Type, float>::value || std::is_same<Type, double>::value, "Elements of arrays must be float or double.");
+
+    return TTK_MeasureArrayErrors(actual, expected, size, min_magnitude, kind).max_error <= tolerance;
+}
+
+// Failure path of TTK_ASSERT_ARRAY_NEAR, TTK_ASSERT_ARRAY_NEAR_ULP and their TTK_EXPECT_... variants.
+template <typename Type>
+TTK_COLD TTK_TRY_FORCE_NON_INLINE
+void TTK_ArrayNearFail(bool is_assert, unsigned line, const char* condition, const char* file_name_utf8, const Type* actual, const Type* expected, size_t size, double tolerance, double min_magnitude, TTK_ArrayErrorKind kind) {
+    const TTK_ArrayErrors errors = TTK_MeasureArrayErrors(actual, expected, size, min_magnitude, kind);
+
+    size_t worst_index                      = 0;
+    size_t number_of_exceeded               = 0;
+    size_t number_of_infinite_errors        = 0;
+    bool   is_worst_found                   = false;
+
+    for (size_t index = 0; index < size; ++index) {
+        const double error = TTK_GetArrayError(actual[index], expected[index], min_magnitude, kind);
+
+        if (error > tolerance)                                  number_of_exceeded += 1;
+        if (error == std::numeric_limits<double>::infinity())   number_of_infinite_errors += 1;
+        if (!is_worst_found && error == errors.max_error) {
+            worst_index     = index;
+            is_worst_found  = true;
+        }
+    }
+
+    const size_t number_of_finite_errors = size - number_of_infinite_errors;
+    const double mean_error = number_of_finite_errors ? errors.sum_of_finite_errors / double(number_of_finite_errors) : 0;
+
+    TTK_TextBuffer message;
+    message.AppendFormat("size: %llu, number of exceeded: %llu, number of infinite errors: %llu, max error: %.6g at: %llu (actual: ", 
+        (unsigned long long)size, (unsigned long long)number_of_exceeded, (unsigned long long)number_of_infinite_errors, errors.max_error, (unsigned long long)worst_index);
+    TTK_FormatValue(message, actual[worst_index]);
+    message.Append(", expected: ");
+    TTK_FormatValue(message, expected[worst_index]);
+    message.AppendFormat("), mean error: %.6g", mean_error);
+
+    if (is_assert) {
+        TTK_AssertFail(line, condition, file_name_utf8, message.Get());
+    } else {
+        TTK_ExpectFail(line, condition, file_name_utf8, message.Get());
+    }
+}
+
+// Counts allocations of block of TTK_ASSERT_MAX_ALLOCS or TTK_ASSERT_NO_ALLOC. Doesn't allocate by itself.
+class TTK_AllocationScope {
+public:
+    explicit TTK_AllocationScope(uint64_t max_number_of_allocations) {
+        m_max_number_of_allocations = max_number_of_allocations;
+        m_begin_counters            = TTK_ToAllocationCounters();
+        m_number_of_allocations     = 0;
+        m_allocated_bytes           = 0;
+        m_is_entered                = false;
+        m_is_checked                = false;
+    }
+
+    virtual ~TTK_AllocationScope() {}
+
+    // Returns true only at first call.
+    bool Enter() {
+        const bool is_first = !m_is_entered;
+        m_is_entered = true;
+        return is_first;
+    }
+
+    bool IsEntered() const {
+        return m_is_entered;
+    }
+
+    bool IsChecked() const {
+        return m_is_checked;
+    }
+
+    // Returns false, if block has allocated too many times, or allocations are not counted.
+    bool Check() {
+        const TTK_AllocationCounters& counters = TTK_ToAllocationCounters();
+
+        m_number_of_allocations = counters.number_of_allocations - m_begin_counters.number_of_allocations;
+        m_allocated_bytes       = counters.allocated_bytes - m_begin_counters.allocated_bytes;
+        m_is_checked            = true;
+
+        return TTK_ToIsAllocationCounted() && m_number_of_allocations <= m_max_number_of_allocations;
+    }
+
+    TTK_COLD TTK_TRY_FORCE_NON_INLINE
+    void Fail(unsigned line, const char* condition, const char* file_name_utf8) const {
+        char message[128] = {};
+        if (TTK_ToIsAllocationCounted()) {
+            snprintf(message, sizeof(message), "number of allocations: %llu, allocated bytes: %llu", 
+                (unsigned long long)m_number_of_allocations, (unsigned long long)m_allocated_bytes);
+        } else {
+            snprintf(message, sizeof(message), "%s", "allocations are not counted (TTK_ALLOCATION_HOOKS is not defined)");
+        }
+        TTK_AssertFail(line, condition, file_name_utf8, message);
+    }
+
+private:
+    uint64_t                m_max_number_of_allocations;
+    TTK_AllocationCounters  m_begin_counters;
+    uint64_t                m_number_of_allocations;
+    uint64_t                m_allocated_bytes;
+    bool                    m_is_entered;
+    bool                    m_is_checked;
+};
+
+// Measures block of TTK_ASSERT_NOT_SLOWER and compares its time with baseline.
+// Number of executions is calibrated and samples are collected as for benchmark function (see TTK_RunBenchmark).
+class TTK_TimingScope {
+public:
+    TTK_TimingScope(const char* key, double tolerance) {
+        m_key                               = key;
+        m_tolerance                         = tolerance;
+
+        m_min_sample_time                   = TTK_ToSuite().GetBenchmarkMinSampleTime();
+        m_number_of_samples                 = TTK_ToSuite().GetBenchmarkNumberOfSamples();
+
+        m_number_of_iterations              = 1;
+        m_number_of_remaining_iterations    = 0;
+        m_begin_time                        = 0;
+
+        m_time                              = 0;
+        m_baseline_time                     = 0;
+
+        m_is_started                        = false;
+        m_is_calibrated                     = false;
+        m_is_measured                       = false;
+        m_is_checked                        = false;
+    }
+
+    virtual ~TTK_TimingScope() {}
+
+    // Returns true, while block should be executed.
+    bool KeepRunning() {
+        if (m_number_of_remaining_iterations != 0) {
+            --m_number_of_remaining_iterations;
+            return true;
+        }
+        return StartNextSample();
+    }
+
+    bool IsMeasured() const {
+        return m_is_measured;
+    }
+
+    bool IsChecked() const {
+        return m_is_checked;
+    }
+
+    // Compares measured time with baseline or records it, depending on mode of baselines. 
+    // Returns false, if block is slower than baseline with tolerance.
+    bool Check() {
+        m_is_checked = true;
+
+        std::sort(m_times.begin(), m_times.end());
+        const size_t middle = m_times.size() / 2;
+        m_time = (m_times.size() % 2) ? m_times[middle] : (m_times[middle - 1] + m_times[middle]) / 2;
+
+        const TTK_BaselineMode  mode        = TTK_ToSuite().GetBaselineMode();
+        const bool              is_baseline = TTK_ToSuite().FindBaseline(m_key, m_baseline_time);
+
+        if (mode == TTK_BASELINE_UPDATE || (mode == TTK_BASELINE_RECORD && !is_baseline)) {
+            TTK_ToSuite().RecordBaseline(m_key, m_time);
+            Note("recorded");
+            return true;
+        }
+        if (!is_baseline) {
+            Note("no baseline");
+            return true;
+        }
+        return m_time <= m_baseline_time * (1 + m_tolerance);
+    }
+
+    TTK_COLD TTK_TRY_FORCE_NON_INLINE
+    void Fail(unsigned line, const char* condition, const char* file_name_utf8) const {
+        char times[128] = {};
+        snprintf(times, sizeof(times), ", time: %.3f ns, baseline: %.3f ns", m_time, m_baseline_time);
+
+        TTK_AssertFail(line, condition, file_name_utf8, "key: " + m_key + times);
+    }
+
+private:
+    TTK_TRY_FORCE_NON_INLINE
+    bool StartNextSample() {
+        if (m_is_started) {
+            const uint64_t elapsed_time = TTK_GetTime() - m_begin_time;
+
+            if (m_is_calibrated) {
+                m_times.push_back(double(elapsed_time) / double(m_number_of_iterations));
+                if (m_times.size() >= m_number_of_samples) {
+                    m_is_measured = true;
+                    return false;
+                }
+            } else if (elapsed_time >= m_min_sample_time) {
+                m_is_calibrated = true;
+                m_times.reserve(m_number_of_samples);
+            } else {
+                // Aims slightly above minimal sample time, growing at least twice and at most ten times per step.
+                uint64_t multiplier = elapsed_time ? (m_min_sample_time * 14) / (elapsed_time * 10) : 10;
+                if (multiplier < 2)  multiplier = 2;
+                if (multiplier > 10) multiplier = 10;
+
+                if (m_number_of_iterations > UINT64_MAX / multiplier) {
+                    m_is_calibrated = true;
+                    m_times.reserve(m_number_of_samples);
+                } else {
+                    m_number_of_iterations *= multiplier;
+                }
+            }
+        }
+
+        m_is_started                        = true;
+        m_number_of_remaining_iterations    = m_number_of_iterations - 1;
+        m_begin_time                        = TTK_GetTime();
+        return true;
+    }
+
+    void Note(const char* state) const {
+        char time[64] = {};
+        snprintf(time, sizeof(time), "] [time:%.3f ns] [", m_time);
+
+        TTK_ToSuite().CommunicateNote("[baseline] [key:" + m_key + time + state + "]");
+    }
+
+    std::string         m_key;
+    double              m_tolerance;
+
+    uint64_t            m_min_sample_time;
+    uint32_t            m_number_of_samples;
+
+    uint64_t            m_number_of_iterations;
+    uint64_t            m_number_of_remaining_iterations;
+    uint64_t            m_begin_time;
+
+    std::vector<double> m_times;            // per execution, in nanoseconds
+    double              m_time;             // median of m_times
+    double              m_baseline_time;
+
+    bool                m_is_started;
+    bool                m_is_calibrated;
+    bool                m_is_measured;
+    bool                m_is_checked;
+};
+
+//------------------------------------------------------------------------------
+
+// Controls iterations of benchmark function and measures their time.
+class TTK_BenchmarkState {
+public:
+    explicit TTK_BenchmarkState(uint64_t number_of_iterations) {
+        m_number_of_iterations              = number_of_iterations;
+        m_number_of_remaining_iterations    = 0;
+
+        m_begin_time                        = 0;
+        m_end_time                          = 0;
+        m_pause_begin_time                  = 0;
+        m_paused_time                       = 0;
+
+        m_is_started                        = false;
+        m_is_finished                       = false;
+    }
+
+    virtual ~TTK_BenchmarkState() {}
+
+    // Returns true, while there are iterations to be executed. 
+    // Time measurement starts at first call and ends at call which returns false.
+    bool KeepRunning() {
+        if (m_number_of_remaining_iterations != 0) {
+            --m_number_of_remaining_iterations;
+            return true;
+        }
+        return StartOrFinish();
+    }
+
+    // Excludes code between PauseTiming and ResumeTiming from measured time (for example setup of each iteration).
+    void PauseTiming() {
+        m_pause_begin_time = TTK_GetTime();
+    }
+
+    void ResumeTiming() {
+        m_paused_time += TTK_GetTime() - m_pause_begin_time;
+    }
+
+    uint64_t GetNumberOfIterations() const {
+        return m_number_of_iterations;
+    }
+
+    bool IsFinished() const {
+        return m_is_finished;
+    }
+
+    // Returns measured time of all iterations without paused time, in nanoseconds.
+    uint64_t GetElapsedTime() const {
+        const uint64_t elapsed_time = m_end_time - m_begin_time;
+        return elapsed_time > m_paused_time ? elapsed_time - m_paused_time : 0;
+    }
+
+private:
+    TTK_TRY_FORCE_NON_INLINE
+    bool StartOrFinish() {
+        if (!m_is_started && m_number_of_iterations != 0) {
+            m_is_started                        = true;
+            m_number_of_remaining_iterations    = m_number_of_iterations - 1;
+            m_begin_time                        = TTK_GetTime();
+            return true;
+        }
+
+        m_end_time      = TTK_GetTime();
+        m_is_finished   = true;
+        return false;
+    }
+
+    uint64_t    m_number_of_iterations;
+    uint64_t    m_number_of_remaining_iterations;
+
+    uint64_t    m_begin_time;
+    uint64_t    m_end_time;
+    uint64_t    m_pause_begin_time;
+    uint64_t    m_paused_time;
+
+    bool        m_is_started;
+    bool        m_is_finished;
+};
+
+using TTK_BenchmarkFnP_T = void (*)(TTK_BenchmarkState&);
+
+// Calibrates number of iterations, collects samples and communicates statistics of time per iteration.
+inline void TTK_RunBenchmark(TTK_BenchmarkFnP_T benchmark_function) {
+    const uint64_t min_sample_time      = TTK_ToSuite().GetBenchmarkMinSampleTime();
+    const uint32_t number_of_samples    = TTK_ToSuite().GetBenchmarkNumberOfSamples();
+
+    uint64_t number_of_iterations = 1;
+
+    for (;;) {
+        TTK_BenchmarkState state(number_of_iterations);
+        benchmark_function(state);
+
+        if (!state.IsFinished()) {
+            TTK_ToSuite().CommunicateNote("[benchmark] [error:benchmark function has not finished iterations]");
+            return;
+        }
+
+        const uint64_t elapsed_time = state.GetElapsedTime();
+        if (elapsed_time >= min_sample_time) break;
+
+        // Aims slightly above minimal sample time, growing at least twice and at most ten times per step.
+        uint64_t multiplier = elapsed_time ? (min_sample_time * 14) / (elapsed_time * 10) : 10;
+        if (multiplier < 2)  multiplier = 2;
+        if (multiplier > 10) multiplier = 10;
+
+        if (number_of_iterations > UINT64_MAX / multiplier) break;
+        number_of_iterations *= multiplier;
+    }
+
+    std::vector<double> times; // per iteration, in nanoseconds
+    times.reserve(number_of_samples);
+
+    for (uint32_t sample_index = 0; sample_index < number_of_samples; ++sample_index) {
+        TTK_BenchmarkState state(number_of_iterations);
+        benchmark_function(state);
+
+        if (!state.IsFinished()) return;
+
+        times.push_back(double(state.GetElapsedTime()) / double(number_of_iterations));
+    }
+
+    std::sort(times.begin(), times.end());
+
+    double sum = 0;
+    for (double time : times) sum += time;
+    const double mean = sum / times.size();
+
+    double square_sum = 0;
+    for (double time : times) square_sum += (time - mean) * (time - mean);
+    const double stddev = times.size() > 1 ? sqrt(square_sum / (times.size() - 1)) : 0;
+
+    const size_t middle = times.size() / 2;
+    const double median = (times.size() % 2) ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+
+    char text[256] = {};
+    snprintf(text, sizeof(text), "[benchmark] [iterations:%llu] [samples:%u] [mean:%.3f ns] [median:%.3f ns] [stddev:%.3f ns] [min:%.3f ns]", 
+        (unsigned long long)number_of_iterations, number_of_samples, mean, median, stddev, times.front());
+
+    TTK_ToSuite().CommunicateNote(text);
+}
+
+template <TTK_BenchmarkFnP_T BenchmarkFunction>
+void TTK_ExecuteBenchmark() {
+    TTK_RunBenchmark(BenchmarkFunction);
+}
+
+// Address of value escapes through volatile variable, so compiler can't assume it's unused (for compilers without inline assembly).
+inline const volatile char*& TTK_ToEscapeSink() {
+    static const volatile char* s_sink = nullptr;
+    return s_sink;
+}
+
+template <typename Type>
+inline void TTK_DoNotOptimize(Type&& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    TTK_ToEscapeSink() = &reinterpret_cast<const volatile char&>(value);
+    _ReadWriteBarrier();
+#endif
+}
+
+inline void TTK_ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+#if !(defined(_MSC_VER) && defined(_M_X64)) && defined(__SIZEOF_INT128__)
+// Extension of GCC and Clang, marked as such to not be reported by -Wpedantic.
+__extension__ typedef unsigned __int128 TTK_UInt128;
+#endif
+
+// Returns high 64 bits of 128-bit product.
+inline uint64_t TTK_MultiplyHigh(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return __umulh(a, b);
+#elif defined(__SIZEOF_INT128__)
+    return uint64_t(TTK_UInt128(a) * b >> 64);
+#else
+    const uint64_t a_low = a & 0xFFFFFFFFull, a_high = a >> 32;
+    const uint64_t b_low = b & 0xFFFFFFFFull, b_high = b >> 32;
+
+    const uint64_t low_low      = a_low * b_low;
+    const uint64_t high_low     = a_high * b_low;
+    const uint64_t low_high     = a_low * b_high;
+    const uint64_t middle       = (low_low >> 32) + (high_low & 0xFFFFFFFFull) + low_high;
+
+    return a_high * b_high + (high_low >> 32) + (middle >> 32);
+#endif
+}
+
+// Fast pseudo-random number generator (xoshiro256**), seeded by splitmix64. Makes the same sequence on every platform.
+class TTK_Random {
+public:
+    explicit TTK_Random(uint64_t seed) {
+        for (uint64_t& state : m_state) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t value = seed;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            state = value ^ (value >> 31);
+        }
+    }
+
+    virtual ~TTK_Random() {}
+
+    uint64_t Next() {
+        const uint64_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = RotateLeft(m_state[3], 45);
+
+        return result;
+    }
+
+    // Returns value from range [0, bound), without division. bound must be greater than 0.
+    uint64_t NextBelow(uint64_t bound) {
+        return TTK_MultiplyHigh(Next(), bound);
+    }
+
+    // Returns value from range [0, 1).
+    double NextUnit() {
+        return double(Next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    static uint64_t RotateLeft(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    uint64_t m_state[4];
+};
+
+// Generators of values for properties. Each generator has:
+//  Value_T                                                 Type of generated value.
+//  void Generate(TTK_Random& random, Value_T& value) const
+//                                                          Overwrites value with random one, reusing its memory.
+//  template <typename TryFnT> bool Shrink(const Value_T& value, TryFnT&& try_candidate) const
+//                                                          Passes candidates simpler than value to try_candidate(const Value_T&), 
+//                                                          until it returns true (body of property still fails for candidate). 
+//                                                          Returns true, if any candidate has been accepted.
+//  void Format(const Value_T& value, std::string& text) const
+//                                                          Appends value to text.
+// Own generators can be used as well, if they have the same members.
+
+template <typename Type>
+class TTK_IntGenerator {
+public:
+    using Value_T = Type;
+
+    TTK_IntGenerator(Type min, Type max) {
+        m_min       = min;
+        m_max       = max;
+        m_origin    = (min > Type(0)) ? min : ((max < Type(0)) ? max : Type(0));
+    }
+
+    virtual ~TTK_IntGenerator() {}
+
+    void Generate(TTK_Random& random, Type& value) const {
+        const uint64_t bits = random.Next();
+
+        // Edge values are picked more often than uniform distribution would pick them.
+        if ((bits & 15) == 0) {
+            const uint64_t edge_index = (bits >> 4) % 3;
+            value = (edge_index == 0) ? m_min : ((edge_index == 1) ? m_max : m_origin);
+            return;
+        }
+
+        const uint64_t span = uint64_t(m_max) - uint64_t(m_min);
+        value = Type(uint64_t(m_min) + ((span == UINT64_MAX) ? random.Next() : random.NextBelow(span + 1)));
+    }
+
+    // Candidates: origin (zero or bound closest to it), then values closer and closer to value (by halves of distance).
+    template <typename TryFnT>
+    bool Shrink(const Type& value, TryFnT&& try_candidate) const {
+        const bool is_above = value > m_origin;
+        const uint64_t distance = is_above ? uint64_t(value) - uint64_t(m_origin) : uint64_t(m_origin) - uint64_t(value);
+
+        for (uint64_t delta = distance; delta != 0; delta /= 2) {
+            const Type candidate = Type(is_above ? uint64_t(value) - delta : uint64_t(value) + delta);
+            if (try_candidate(candidate)) return true;
+        }
+        return false;
+    }
+
+    void Format(const Type& value, std::string& text) const {
+        char buffer[32] = {};
+        if (std::is_signed<Type>::value) {
+            snprintf(buffer, sizeof(buffer), "%lld", (long long)value);
+        } else {
+            snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)value);
+        }
+        text += buffer;
+    }
+
+private:
+    Type m_min;
+    Type m_max;
+    Type m_origin;
+};
+
+template <typename Type>
+class TTK_RealGenerator {
+public:
+    using Value_T = Type;
+
+    TTK_RealGenerator(Type min, Type max) {
+        m_min       = min;
+        m_max       = max;
+        m_origin    = (min > Type(0)) ? min : ((max < Type(0)) ? max : Type(0));
+    }
+
+    virtual ~TTK_RealGenerator() {}
+
+    void Generate(TTK_Random& random, Type& value) const {
+        const uint64_t bits = random.Next();
+
+        if ((bits & 15) == 0) {
+            const uint64_t edge_index = (bits >> 4) % 3;
+            value = (edge_index == 0) ? m_min : ((edge_index == 1) ? m_max : m_origin);
+            return;
+        }
+
+        value = Type(m_min + (m_max - m_min) * random.NextUnit());
+        if (value > m_max) value = m_max;
+    }
+
+    // Candidates: origin, value without fraction, then values closer and closer to value (by halves of distance).
+    template <typename TryFnT>
+    bool Shrink(const Type& value, TryFnT&& try_candidate) const {
+        if (value != value || value == m_origin) return false;
+
+        if (try_candidate(m_origin)) return true;
+
+        const Type truncated = Type(trunc(value));
+        if (truncated != value && truncated >= m_min && truncated <= m_max && try_candidate(truncated)) return true;
+
+        Type delta = (value - m_origin) / 2;
+        for (int attempt = 0; attempt < 64; ++attempt, delta /= 2) {
+            const Type candidate = value - delta;
+            if (candidate == value) break;
+            if (try_candidate(candidate)) return true;
+        }
+        return false;
+    }
+
+    void Format(const Type& value, std::string& text) const {
+        char buffer[64] = {};
+        snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<Type>::max_digits10, double(value));
+        text += buffer;
+    }
+
+private:
+    Type m_min;
+    Type m_max;
+    Type m_origin;
+};
+
+class TTK_BoolGenerator {
+public:
+    using Value_T = bool;
+
+    TTK_BoolGenerator() {}
+    virtual ~TTK_BoolGenerator() {}
+
+    void Generate(TTK_Random& random, bool& value) const {
+        value = (random.Next() >> 63) != 0;
+    }
+
+    template <typename TryFnT>
+    bool Shrink(const bool& value, TryFnT&& try_candidate) const {
+        return value && try_candidate(false);
+    }
+
+    void Format(const bool& value, std::string& text) const {
+        text += value ? "true" : "false";
+    }
+};
+
+// Generates containers with random size (std::vector, except std::vector<bool>, or std::string).
+template <typename ContainerType, typename ElementGeneratorType>
+class TTK_SequenceGenerator {
+public:
+    using Value_T   = ContainerType;
+    using Element_T = typename ContainerType::value_type;
+
+    TTK_SequenceGenerator(const ElementGeneratorType& element_generator, size_t min_size, size_t max_size) : m_element_generator(element_generator) {
+        m_min_size  = min_size;
+        m_max_size  = max_size > min_size ? max_size : min_size;
+    }
+
+    virtual ~TTK_SequenceGenerator() {}
+
+    void Generate(TTK_Random& random, ContainerType& value) const {
+        value.resize(m_min_size + size_t(random.NextBelow(uint64_t(m_max_size - m_min_size) + 1)));
+
+        for (Element_T& element : value) m_element_generator.Generate(random, element);
+    }
+
+    // Candidates: value without chunk of elements (from largest chunks to single elements), then value with single simpler element.
+    template <typename TryFnT>
+    bool Shrink(const ContainerType& value, TryFnT&& try_candidate) const {
+        ContainerType candidate;
+
+        for (size_t chunk_size = value.size() - m_min_size; chunk_size != 0; chunk_size /= 2) {
+            for (size_t begin = 0; begin + chunk_size <= value.size(); begin += chunk_size) {
+                candidate.assign(value.begin(), value.begin() + begin);
+                candidate.insert(candidate.end(), value.begin() + begin + chunk_size, value.end());
+                if (try_candidate(candidate)) return true;
+            }
+        }
+
+        candidate = value;
+        for (size_t index = 0; index < value.size(); ++index) {
+            const bool is_shrunk = m_element_generator.Shrink(value[index], [&](const Element_T& element) -> bool {
+                candidate[index] = element;
+                return try_candidate(candidate);
+            });
+            if (is_shrunk) return true;
+
+            candidate[index] = value[index];
+        }
+        return false;
+    }
+
+    void Format(const ContainerType& value, std::string& text) const {
+        FormatSequence(value, text);
+    }
+
+private:
+    void FormatSequence(const std::string& value, std::string& text) const {
+        text += '"';
+        text += value;
+        text += '"';
+    }
+
+    template <typename OtherContainerType>
+    void FormatSequence(const OtherContainerType& value, std::string& text) const {
+        text += '[';
+        for (size_t index = 0; index < value.size(); ++index) {
+            if (index != 0) text += ", ";
+            m_element_generator.Format(value[index], text);
+        }
+        text += ']';
+    }
+
+    ElementGeneratorType    m_element_generator;
+    size_t                  m_min_size;
+    size_t                  m_max_size;
+};
+
+// Generates std::tuple, which elements are made by separate generators.
+template <typename... ElementGeneratorTypes>
+class TTK_TupleGenerator {
+public:
+    using Value_T = std::tuple<typename ElementGeneratorTypes::Value_T...>;
+
+    explicit TTK_TupleGenerator(const ElementGeneratorTypes&... element_generators) : m_element_generators(element_generators...) {}
+
+    virtual ~TTK_TupleGenerator() {}
+
+    void Generate(TTK_Random& random, Value_T& value) const {
+        GenerateFrom(random, value, std::integral_constant<size_t, 0>());
+    }
+
+    // Candidates: value with single simpler element, from first element to last one.
+    template <typename TryFnT>
+    bool Shrink(const Value_T& value, TryFnT&& try_candidate) const {
+        return ShrinkFrom(value, try_candidate, std::integral_constant<size_t, 0>());
+    }
+
+    void Format(const Value_T& value, std::string& text) const {
+        text += '(';
+        FormatFrom(value, text, std::integral_constant<size_t, 0>());
+        text += ')';
+    }
+
+private:
+    using End_T = std::integral_constant<size_t, sizeof...(ElementGeneratorTypes)>;
+
+    template <size_t INDEX>
+    void GenerateFrom(TTK_Random& random, Value_T& value, std::integral_constant<size_t, INDEX>) const {
+        std::get<INDEX>(m_element_generators).Generate(random, std::get<INDEX>(value));
+        GenerateFrom(random, value, std::integral_constant<size_t, INDEX + 1>());
+    }
+
+    void GenerateFrom(TTK_Random&, Value_T&, End_T) const {}
+
+    template <typename TryFnT, size_t INDEX>
+    bool ShrinkFrom(const Value_T& value, TryFnT& try_candidate, std::integral_constant<size_t, INDEX>) const {
+        using Element_T = typename std::tuple_element<INDEX, Value_T>::type;
+
+        Value_T candidate = value;
+        const bool is_shrunk = std::get<INDEX>(m_element_generators).Shrink(std::get<INDEX>(value), [&](const Element_T& element) -> bool {
+            std::get<INDEX>(candidate) = element;
+            return try_candidate(candidate);
+        });
+
+        return is_shrunk || ShrinkFrom(value, try_candidate, std::integral_constant<size_t, INDEX + 1>());
+    }
+
+    template <typename TryFnT>
+    bool ShrinkFrom(const Value_T&, TryFnT&, End_T) const { 
+        return false; 
+    }
+
+    template <size_t INDEX>
+    void FormatFrom(const Value_T& value, std::string& text, std::integral_constant<size_t, INDEX>) const {
+        if (INDEX != 0) text += ", ";
+        std::get<INDEX>(m_element_generators).Format(std::get<INDEX>(value), text);
+        FormatFrom(value, text, std::integral_constant<size_t, INDEX + 1>());
+    }
+
+    void FormatFrom(const Value_T&, std::string&, End_T) const {}
+
+    std::tuple<ElementGeneratorTypes...> m_element_generators;
+};
+
+// Integer from range [min, max].
+template <typename Type>
+TTK_IntGenerator<Type> TTK_GenInt(Type min = std::numeric_limits<Type>::min(), Type max = std::numeric_limits<Type>::max()) {
+    return TTK_IntGenerator<Type>(min, max);
+}
+
+// Floating point number from range [min, max].
+template <typename Type>
+TTK_RealGenerator<Type> TTK_GenReal(Type min, Type max) {
+    return TTK_RealGenerator<Type>(min, max);
+}
+
+inline TTK_BoolGenerator TTK_GenBool() {
+    return TTK_BoolGenerator();
+}
+
+// std::vector with number of elements from range [min_size, max_size], which elements are made by element_generator.
+template <typename ElementGeneratorType>
+TTK_SequenceGenerator<std::vector<typename ElementGeneratorType::Value_T>, ElementGeneratorType> TTK_GenVector(const ElementGeneratorType& element_generator, size_t min_size, size_t max_size) {
+    return TTK_SequenceGenerator<std::vector<typename ElementGeneratorType::Value_T>, ElementGeneratorType>(element_generator, min_size, max_size);
+}
+
+// std::string with length from range [min_size, max_size], which characters are from range [min_character, max_character] (printable ascii by default).
+inline TTK_SequenceGenerator<std::string, TTK_IntGenerator<char>> TTK_GenString(size_t min_size, size_t max_size, char min_character = ' ', char max_character = '~') {
+    return TTK_SequenceGenerator<std::string, TTK_IntGenerator<char>>(TTK_IntGenerator<char>(min_character, max_character), min_size, max_size);
+}
+
+template <typename... ElementGeneratorTypes>
+TTK_TupleGenerator<ElementGeneratorTypes...> TTK_GenTuple(const ElementGeneratorTypes&... element_generators) {
+    return TTK_TupleGenerator<ElementGeneratorTypes...>(element_generators...);
+}
+
+enum : uint64_t {
+    TTK_PROPERTY_MAX_SHRINK_TRIES = 100000,     // maximal number of candidates checked while shrinking single counterexample
+};
+
+template <typename GeneratorType>
+void TTK_CheckProperty(const GeneratorType& generator, void (*property)(const typename GeneratorType::Value_T& param), const char* name) {
+    using Value_T = typename GeneratorType::Value_T;
+
+    const uint64_t number_of_cases  = TTK_ToSuite().GetPropertyNumberOfCases();
+    const uint64_t max_time         = TTK_ToSuite().GetPropertyMaxTime();
+    const uint64_t seed             = TTK_ToSuite().GetPropertySeed();
+
+    TTK_Random random(seed ^ TTK_HashName(name));
+
+    TTK_PropertyProbe probe = {};
+    TTK_PropertyProbe* const previous_probe = TTK_ToPropertyProbe();
+    TTK_ToPropertyProbe() = &probe;
+
+    const uint64_t begin_time = TTK_GetTime();
+
+    Value_T value = Value_T();
+    uint64_t case_index = 0;
+    bool is_fail = false;
+
+    for (; number_of_cases == 0 || case_index < number_of_cases; ++case_index) {
+        if (max_time && (case_index % 256) == 0 && case_index != 0 && TTK_GetTime() - begin_time >= max_time) break;
+
+        generator.Generate(random, value);
+
+        probe.number_of_fails = 0;
+        property(value);
+
+        if (TTK_UNLIKELY(probe.number_of_fails != 0)) {
+            is_fail = true;
+            break;
+        }
+    }
+
+    if (is_fail) {
+        Value_T counterexample  = value;
+        Value_T accepted        = value;
+
+        uint64_t number_of_shrink_steps = 0;
+        uint64_t number_of_tries        = 0;
+
+        auto try_candidate = [&](const Value_T& candidate) -> bool {
+            if (number_of_tries >= TTK_PROPERTY_MAX_SHRINK_TRIES) return false;
+            ++number_of_tries;
+
+            probe.number_of_fails = 0;
+            property(candidate);
+
+            if (probe.number_of_fails == 0) return false;
+            accepted = candidate;
+            return true;
+        };
+
+        while (number_of_tries < TTK_PROPERTY_MAX_SHRINK_TRIES && generator.Shrink(counterexample, try_candidate)) {
+            std::swap(counterexample, accepted);
+            ++number_of_shrink_steps;
+        }
+
+        TTK_ToPropertyProbe() = previous_probe;
+
+        // Probe holds fail of last failed check, which is check of counterexample.
+        std::string message = probe.is_message ? probe.message + ", " : std::string();
+        message += "falsified by counterexample: ";
+        generator.Format(counterexample, message);
+
+        char text[256] = {};
+        snprintf(text, sizeof(text), " (seed: %llu, case: %llu, shrink steps: %llu)", 
+            (unsigned long long)seed, (unsigned long long)case_index, (unsigned long long)number_of_shrink_steps);
+        message += text;
+
+        TTK_AssertFail(probe.line, probe.condition, probe.file_name_utf8, message);
+    } else {
+        TTK_ToPropertyProbe() = previous_probe;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Allocation hooks (see TTK_ALLOCATION_HOOKS). Defined only in translation unit which defines TTK_ALLOCATION_HOOKS.
+//------------------------------------------------------------------------------
+
+#if defined(TTK_ALLOCATION_HOOKS)
+
+#include <new>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+// Returns size of allocated memory block.
+inline size_t TTK_GetAllocationSize(void* memory) {
+#if defined(_WIN32)
+    return _msize(memory);
+#elif defined(__APPLE__)
+    return malloc_size(memory);
+#elif defined(__GLIBC__)
+    return malloc_usable_size(memory);
+#else
+    (void)memory;
+    return 0;
+#endif
+}
+
+static const bool s_ttk_is_allocation_counted = (TTK_ToIsAllocationCounted() = true);
+
+#if defined(__GLIBC__)
+// Functions of glibc, which are called by replaced allocation functions.
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t number, size_t size);
+extern "C" void* __libc_realloc(void* memory, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+extern "C" void  __libc_free(void* memory);
+
+extern "C" void* malloc(size_t size) noexcept {
+    void* memory = __libc_malloc(size);
+    if (memory) TTK_CountAllocation(TTK_GetAllocationSize(memory));
+    return memory;
+}
+
+extern "C" void* calloc(size_t number, size_t size) noexcept {
+    void* memory = __libc_calloc(number, size);
+    if (memory) TTK_CountAllocation(TTK_GetAllocationSize(memory));
+    return memory;
+}
+
+extern "C" void* realloc(void* memory, size_t size) noexcept {
+    const size_t previous_size = memory ? TTK_GetAllocationSize(memory) : 0;
+
+    void* new_memory = __libc_realloc(memory, size);
+    if (new_memory) {
+        TTK_CountFree(previous_size);
+        TTK_CountAllocation(TTK_GetAllocationSize(new_memory));
+    } else if (memory && size == 0) {
+        TTK_CountFree(previous_size); // freed by realloc
+    }
+    return new_memory;
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) noexcept {
+    void* memory = __libc_memalign(alignment, size);
+    if (memory) TTK_CountAllocation(TTK_GetAllocationSize(memory));
+    return memory;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    return memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** memory, size_t alignment, size_t size) noexcept {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+
+    void* new_memory = memalign(alignment, size);
+    if (!new_memory) return ENOMEM;
+
+    *memory = new_memory;
+    return 0;
+}
+
+extern "C" void free(void* memory) noexcept {
+    if (memory) TTK_CountFree(TTK_GetAllocationSize(memory));
+    __libc_free(memory);
+}
+
+// malloc and free count allocations by themselves.
+inline void* TTK_AllocateForNew(size_t size) {
+    return malloc(size);
+}
+
+inline void TTK_FreeForDelete(void* memory) {
+    free(memory);
+}
+#else
+inline void* TTK_AllocateForNew(size_t size) {
+    void* memory = malloc(size);
+    if (memory) TTK_CountAllocation(TTK_GetAllocationSize(memory));
+    return memory;
 }
 
+inline void TTK_FreeForDelete(void* memory) {
+    if (memory) TTK_CountFree(TTK_GetAllocationSize(memory));
+    free(memory);
+}
+#endif
+
+// Allocates memory for operator new. Calls new handler until allocation succeeds, or there is no new handler.
+inline void* TTK_AllocateForNewOrFail(size_t size) {
+    for (;;) {
+        void* memory = TTK_AllocateForNew(size ? size : 1);
+        if (memory) return memory;
+
+        std::new_handler new_handler = std::get_new_handler();
+        if (!new_handler) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+            throw std::bad_alloc();
+#else
+            abort();
+#endif
+        }
+        new_handler();
+    }
+}
+
+void* operator new(size_t size) {
+    return TTK_AllocateForNewOrFail(size);
+}
+
+void* operator new[](size_t size) {
+    return TTK_AllocateForNewOrFail(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return TTK_AllocateForNew(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return TTK_AllocateForNew(size ? size : 1);
+}
+
+void operator delete(void* memory) noexcept {
+    TTK_FreeForDelete(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    TTK_FreeForDelete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    TTK_FreeForDelete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    TTK_FreeForDelete(memory);
+}
+
+#if defined(__cpp_sized_deallocation) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+void operator delete(void* memory, size_t) noexcept {
+    TTK_FreeForDelete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    TTK_FreeForDelete(memory);
+}
+#endif
+
+#endif // TTK_ALLOCATION_HOOKS
+
 #endif // TRIVIALTESTKIT_H_
 